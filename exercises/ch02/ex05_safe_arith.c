@@ -0,0 +1,315 @@
+/*
+ * Exercise 2.5: Safe Integer Arithmetic
+ *
+ * Exercise 2.3 shows what happens when a char goes past its limits: it
+ * silently wraps. This exercise uses ../common/safeint.h, which gives
+ * two safer choices for every integer type from int8_t to uint64_t:
+ *
+ *   checked_add_i32(a, b, &r)   returns 0 instead of giving a wrong r
+ *   sat_add_u8(a, b)            clamps to 0..255 instead of wrapping
+ *
+ * plus array versions that check or clamp a whole batch and report a
+ * single flag, timed here against the obvious loop that tests every
+ * element with an if.
+ *
+ * Python equivalent (Python ints never overflow, so you'd check by hand):
+ *   r = a + b
+ *   if not -2**31 <= r < 2**31:
+ *       raise OverflowError
+ *   clamped = max(0, min(255, a + b))
+ *
+ * Compile: cc -Wall -O2 -o ex05_safe_arith ex05_safe_arith.c ../common/safeint.c
+ * Run: ./ex05_safe_arith
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "../common/safeint.h"
+
+#define BENCH_COUNT (1 << 16)   // Elements per array (fits in L2)
+#define BENCH_REPEAT 2000
+#define CHECK_COUNT 100003      // Odd, so the scalar tail runs too
+
+// Function prototypes
+void show_scalar(void);
+int check_arrays(void);
+void benchmark(void);
+uint64_t random_u64(void);
+int naive_sat_add_i16(int16_t *out, const int16_t *a, const int16_t *b, size_t n);
+int naive_sat_add_u8(uint8_t *out, const uint8_t *a, const uint8_t *b, size_t n);
+int naive_checked_add_i32(int32_t *out, const int32_t *a, const int32_t *b, size_t n);
+int naive_checked_sub_i64(int64_t *out, const int64_t *a, const int64_t *b, size_t n);
+int naive_sat_mul_i16(int16_t *out, const int16_t *a, const int16_t *b, size_t n);
+
+int main(void) {
+    show_scalar();
+
+    printf("\nArray versions against the scalar functions: ");
+    if (!check_arrays()) {
+        return 1;
+    }
+    printf("all match\n\n");
+
+    benchmark();
+    return 0;
+}
+
+// --- Scalar ---
+
+void show_scalar(void) {
+    uint8_t u8 = 250;
+    int8_t i8 = 127;
+    int32_t i32;
+    int64_t i64;
+
+    printf("=== Wrapping vs checked vs saturating ===\n");
+    printf("uint8_t 250 + 10:   wraps to %d, saturates to %d\n",
+           (uint8_t)(u8 + 10), sat_add_u8(u8, 10));
+    printf("uint8_t 5 - 10:     wraps to %d, saturates to %d\n",
+           (uint8_t)(5 - 10), sat_sub_u8(5, 10));
+    printf("int8_t 127 + 1:     wraps to %d, saturates to %d\n",
+           (int8_t)(i8 + 1), sat_add_i8(i8, 1));
+    printf("int8_t -128 * -1:   saturates to %d\n", sat_mul_i8(INT8_MIN, -1));
+
+    if (checked_add_i32(INT32_MAX - 5, 5, &i32)) {
+        printf("INT32_MAX - 5 + 5:  ok, %d\n", i32);
+    }
+    if (!checked_add_i32(INT32_MAX, 1, &i32)) {
+        printf("INT32_MAX + 1:      overflow reported\n");
+    }
+    if (!checked_mul_i64(3037000500LL, 3037000500LL, &i64)) {
+        printf("3037000500^2:       overflow reported (int64_t)\n");
+    }
+    printf("int64_t 3037000500^2 saturates to %lld\n",
+           (long long)sat_mul_i64(3037000500LL, 3037000500LL));
+    printf("uint32_t 70000 * 70000 saturates to %u\n", sat_mul_u32(70000, 70000));
+}
+
+// --- Checking the array versions ---
+
+uint64_t random_u64(void) {
+    // Mostly edge values, where the bugs live, mixed with random ones
+    static const uint64_t edges[] = {
+        0, 1, 2, 0x7F, 0x80, 0xFF, 0x7FFF, 0x8000, 0xFFFF, 0x7FFFFFFF,
+        0x80000000, 0xFFFFFFFF, 0x7FFFFFFFFFFFFFFF, 0x8000000000000000,
+    };
+    uint64_t r = (uint64_t)rand() << 42 ^ (uint64_t)rand() << 21 ^ (uint64_t)rand();
+    switch (rand() % 4) {
+    case 0:
+        return edges[rand() % (sizeof(edges) / sizeof(edges[0]))] + (uint64_t)(rand() % 3) - 1;
+    case 1:
+        return r >> (rand() % 64);   // Small magnitudes
+    default:
+        return r;
+    }
+}
+
+// Fill a and b, run every array function for the type and compare each
+// element and the returned flag with the scalar version
+#define CHECK_TYPE(T, NAME, OP, N)                                               \
+    do {                                                                         \
+        int ok_sat = 1, ok_checked = 1;                                          \
+        for (size_t i = 0; i < (N); i++) {                                       \
+            T r;                                                                 \
+            if (!checked_##OP##_##NAME(a_##NAME[i], b_##NAME[i], &r)) {          \
+                ok_checked = 0;                                                  \
+            }                                                                    \
+            want_sat_##NAME[i] = sat_##OP##_##NAME(a_##NAME[i], b_##NAME[i]);    \
+            want_checked_##NAME[i] = r;                                          \
+            ok_sat &= want_sat_##NAME[i] == r;                                   \
+        }                                                                        \
+        if (sat_##OP##_##NAME##_array(out_##NAME, a_##NAME, b_##NAME, (N)) != ok_sat \
+            || memcmp(out_##NAME, want_sat_##NAME, (N) * sizeof(T)) != 0) {      \
+            printf("sat_" #OP "_" #NAME "_array differs!\n");                    \
+            return 0;                                                            \
+        }                                                                        \
+        if (checked_##OP##_##NAME##_array(out_##NAME, a_##NAME, b_##NAME, (N)) != ok_checked \
+            || memcmp(out_##NAME, want_checked_##NAME, (N) * sizeof(T)) != 0) {  \
+            printf("checked_" #OP "_" #NAME "_array differs!\n");                \
+            return 0;                                                            \
+        }                                                                        \
+    } while (0)
+
+#define DECLARE_BUFFERS(T, NAME)                                                 \
+    static T a_##NAME[CHECK_COUNT], b_##NAME[CHECK_COUNT], out_##NAME[CHECK_COUNT]; \
+    static T want_sat_##NAME[CHECK_COUNT], want_checked_##NAME[CHECK_COUNT]
+
+#define CHECK_RANDOM(T, NAME)                                                    \
+    do {                                                                         \
+        for (size_t i = 0; i < CHECK_COUNT; i++) {                               \
+            a_##NAME[i] = (T)random_u64();                                       \
+            b_##NAME[i] = (T)random_u64();                                       \
+        }                                                                        \
+        CHECK_TYPE(T, NAME, add, CHECK_COUNT);                                   \
+        CHECK_TYPE(T, NAME, sub, CHECK_COUNT);                                   \
+        CHECK_TYPE(T, NAME, mul, CHECK_COUNT);                                   \
+        /* Small values: the nothing-overflowed path */                  \
+        for (size_t i = 0; i < CHECK_COUNT; i++) {                               \
+            a_##NAME[i] = (T)(rand() % 10);                                      \
+            b_##NAME[i] = (T)(rand() % 10);                                      \
+        }                                                                        \
+        CHECK_TYPE(T, NAME, add, CHECK_COUNT);                                   \
+        CHECK_TYPE(T, NAME, mul, CHECK_COUNT);                                   \
+    } while (0)
+
+// 8-bit types are small enough to try every pair of inputs
+#define CHECK_EVERY_PAIR(T, NAME)                                                \
+    do {                                                                         \
+        for (size_t i = 0; i < 65536; i++) {                                     \
+            a_##NAME[i] = (T)(i >> 8);                                           \
+            b_##NAME[i] = (T)i;                                                  \
+        }                                                                        \
+        CHECK_TYPE(T, NAME, add, 65536);                                         \
+        CHECK_TYPE(T, NAME, sub, 65536);                                         \
+        CHECK_TYPE(T, NAME, mul, 65536);                                         \
+    } while (0)
+
+int check_arrays(void) {
+    DECLARE_BUFFERS(int8_t, i8);
+    DECLARE_BUFFERS(int16_t, i16);
+    DECLARE_BUFFERS(int32_t, i32);
+    DECLARE_BUFFERS(int64_t, i64);
+    DECLARE_BUFFERS(uint8_t, u8);
+    DECLARE_BUFFERS(uint16_t, u16);
+    DECLARE_BUFFERS(uint32_t, u32);
+    DECLARE_BUFFERS(uint64_t, u64);
+
+    srand(7);
+    CHECK_EVERY_PAIR(int8_t, i8);
+    CHECK_EVERY_PAIR(uint8_t, u8);
+    CHECK_RANDOM(int8_t, i8);
+    CHECK_RANDOM(int16_t, i16);
+    CHECK_RANDOM(int32_t, i32);
+    CHECK_RANDOM(int64_t, i64);
+    CHECK_RANDOM(uint8_t, u8);
+    CHECK_RANDOM(uint16_t, u16);
+    CHECK_RANDOM(uint32_t, u32);
+    CHECK_RANDOM(uint64_t, u64);
+    return 1;
+}
+
+// --- Naive loops: one if per element ---
+
+int naive_sat_add_u8(uint8_t *out, const uint8_t *a, const uint8_t *b, size_t n) {
+    int ok = 1;
+    for (size_t i = 0; i < n; i++) {
+        if (a[i] > UINT8_MAX - b[i]) {
+            out[i] = UINT8_MAX;
+            ok = 0;
+        } else {
+            out[i] = a[i] + b[i];
+        }
+    }
+    return ok;
+}
+
+int naive_sat_add_i16(int16_t *out, const int16_t *a, const int16_t *b, size_t n) {
+    int ok = 1;
+    for (size_t i = 0; i < n; i++) {
+        if (b[i] > 0 && a[i] > INT16_MAX - b[i]) {
+            out[i] = INT16_MAX;
+            ok = 0;
+        } else if (b[i] < 0 && a[i] < INT16_MIN - b[i]) {
+            out[i] = INT16_MIN;
+            ok = 0;
+        } else {
+            out[i] = a[i] + b[i];
+        }
+    }
+    return ok;
+}
+
+int naive_sat_mul_i16(int16_t *out, const int16_t *a, const int16_t *b, size_t n) {
+    int ok = 1;
+    for (size_t i = 0; i < n; i++) {
+        int32_t p = (int32_t)a[i] * b[i];
+        if (p > INT16_MAX) {
+            out[i] = INT16_MAX;
+            ok = 0;
+        } else if (p < INT16_MIN) {
+            out[i] = INT16_MIN;
+            ok = 0;
+        } else {
+            out[i] = (int16_t)p;
+        }
+    }
+    return ok;
+}
+
+int naive_checked_add_i32(int32_t *out, const int32_t *a, const int32_t *b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (!checked_add_i32(a[i], b[i], &out[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int naive_checked_sub_i64(int64_t *out, const int64_t *a, const int64_t *b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (!checked_sub_i64(a[i], b[i], &out[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// --- Benchmark ---
+
+static double melements_per_second(clock_t start, clock_t end) {
+    double seconds = (double)(end - start) / CLOCKS_PER_SEC;
+    if (seconds <= 0) seconds = 1e-9;
+    return (double)BENCH_COUNT * BENCH_REPEAT / seconds / 1e6;
+}
+
+void benchmark(void) {
+    static uint8_t a8[BENCH_COUNT], b8[BENCH_COUNT], out8[BENCH_COUNT];
+    static int16_t a16[BENCH_COUNT], b16[BENCH_COUNT], out16[BENCH_COUNT];
+    static int32_t a32[BENCH_COUNT], b32[BENCH_COUNT], out32[BENCH_COUNT];
+    static int64_t a64[BENCH_COUNT], b64[BENCH_COUNT], out64[BENCH_COUNT];
+    clock_t start, end;
+    volatile int flag = 0;   // Keeps the results "used"
+
+    // Random 8/16-bit values overflow often, so the naive if is hard to
+    // predict. The checked 32/64-bit data never overflows, so the naive
+    // loop gets its best case: it has to run to the end too.
+    srand(42);
+    for (size_t i = 0; i < BENCH_COUNT; i++) {
+        a8[i] = (uint8_t)rand();
+        b8[i] = (uint8_t)rand();
+        a16[i] = (int16_t)rand();
+        b16[i] = (int16_t)rand();
+        a32[i] = rand() - RAND_MAX / 2;
+        b32[i] = rand() - RAND_MAX / 2;
+        a64[i] = (int64_t)random_u64() >> 2;
+        b64[i] = (int64_t)random_u64() >> 2;
+    }
+
+    printf("=== Benchmark (%d elements x %d) ===\n", BENCH_COUNT, BENCH_REPEAT);
+    printf("%-32s %12s\n", "", "Melements/s");
+
+#define TIME_KERNEL(label, call)                                                  \
+    do {                                                                          \
+        start = clock();                                                          \
+        for (int r = 0; r < BENCH_REPEAT; r++) {                                  \
+            flag += call;                                                         \
+        }                                                                         \
+        end = clock();                                                            \
+        printf("%-32s %12.1f\n", label, melements_per_second(start, end));       \
+    } while (0)
+
+    TIME_KERNEL("naive saturating add u8", naive_sat_add_u8(out8, a8, b8, BENCH_COUNT));
+    TIME_KERNEL("sat_add_u8_array", sat_add_u8_array(out8, a8, b8, BENCH_COUNT));
+    TIME_KERNEL("naive saturating add i16", naive_sat_add_i16(out16, a16, b16, BENCH_COUNT));
+    TIME_KERNEL("sat_add_i16_array", sat_add_i16_array(out16, a16, b16, BENCH_COUNT));
+    TIME_KERNEL("naive saturating mul i16", naive_sat_mul_i16(out16, a16, b16, BENCH_COUNT));
+    TIME_KERNEL("sat_mul_i16_array", sat_mul_i16_array(out16, a16, b16, BENCH_COUNT));
+    TIME_KERNEL("naive checked add i32", naive_checked_add_i32(out32, a32, b32, BENCH_COUNT));
+    TIME_KERNEL("checked_add_i32_array", checked_add_i32_array(out32, a32, b32, BENCH_COUNT));
+    TIME_KERNEL("naive checked sub i64", naive_checked_sub_i64(out64, a64, b64, BENCH_COUNT));
+    TIME_KERNEL("checked_sub_i64_array", checked_sub_i64_array(out64, a64, b64, BENCH_COUNT));
+#undef TIME_KERNEL
+}
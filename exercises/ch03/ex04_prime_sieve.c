@@ -0,0 +1,575 @@
+/*
+ * Exercise 3.4: Segmented Prime Sieve
+ *
+ * Exercise 3.2 tests each number with trial division. To find every
+ * prime up to 10^10 we flip the question around (Sieve of Eratosthenes):
+ * start with "everything is prime" and cross off the multiples of each
+ * prime p <= sqrt(limit). What is left is prime.
+ *
+ * Three tricks make it fast:
+ *
+ *   - Wheel: only numbers coprime to 2*3*5 = 30 can be prime (besides
+ *     2, 3, 5), and each block of 30 has exactly 8 of them:
+ *         1, 7, 11, 13, 17, 19, 23, 29
+ *     so one byte covers 30 numbers - 10^10 needs 333 MB of bits
+ *     otherwise, but we never hold it all because...
+ *   - Segments: sieve 32 KiB (one L1 data cache, ~1 million numbers) at
+ *     a time, counting or emitting primes before moving on.
+ *   - Threads: each thread sieves its own run of segments.
+ *
+ * Crossing off: for prime p and a multiplier k coprime to 30, p*k and
+ * p*(k + 30) are 30p apart - exactly p bytes, same bit. So each prime
+ * has 8 "lanes" (one per residue of k), each a simple stride-p loop.
+ *
+ * Python equivalent (for small limits):
+ *   sieve = bytearray([1]) * (n + 1)
+ *   for p in range(2, int(n ** 0.5) + 1):
+ *       if sieve[p]:
+ *           sieve[p*p::p] = bytes(len(range(p*p, n + 1, p)))
+ *
+ * Compile: cc -Wall -O2 -pthread -o ex04_prime_sieve ex04_prime_sieve.c
+ * Run: ./ex04_prime_sieve                  (demo and timing table)
+ *      ./ex04_prime_sieve -t 4 10000000000 (count primes up to 10^10)
+ *      ./ex04_prime_sieve -p 1000          (print primes up to 1000)
+ *      ./ex04_prime_sieve -o primes.bin 1000000000
+ *      ./ex04_prime_sieve -d primes.bin    (decode and count a file)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#define SEGMENT_BYTES 32768      // 32 KiB = 983040 numbers per segment
+#define ROUND_SEGMENTS 16        // Segments per thread per round when emitting
+#define MAX_THREADS 64
+#define DELTA_MAGIC "PRIMEDL1"
+
+typedef void (*PrimeCallback)(uint64_t prime, void *ctx);
+
+// The 8 residues mod 30 that can be prime, and which bit each one uses
+static const uint8_t wheel_residues[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+static int8_t wheel_bit[30];
+
+// Crossing-off state for one sieving prime: the next byte to mark in
+// each of its 8 lanes (absolute byte index n / 30) and that lane's bit
+typedef struct {
+    uint64_t prime;
+    uint64_t next[8];
+    uint8_t mask[8];
+} SievePrime;
+
+typedef struct {
+    uint64_t limit;
+    uint64_t total_bytes;     // limit / 30 + 1
+    uint64_t total_segments;
+    SievePrime *primes;       // Template; each worker has its own copy
+    size_t prime_count;
+} Sieve;
+
+typedef struct {
+    const Sieve *sieve;
+    SievePrime *primes;
+    uint8_t *buffer;          // seg_count segments back to back
+    uint64_t first_segment;
+    uint64_t seg_count;
+    uint64_t count;           // Primes found in this worker's segments
+    int do_count;
+} Worker;
+
+// Delta-encoded output: varint(gap / 2) between consecutive odd primes
+typedef struct {
+    FILE *out;
+    uint64_t prev;
+    unsigned char buf[65536];
+    size_t used;
+    int ok;
+} DeltaWriter;
+
+// Function prototypes
+int sieve_init(Sieve *sieve, uint64_t limit);
+void sieve_free(Sieve *sieve);
+uint64_t sieve_count(uint64_t limit, int threads);
+int sieve_each(uint64_t limit, int threads, PrimeCallback callback, void *ctx);
+
+int delta_writer_open(DeltaWriter *w, const char *path, uint64_t limit);
+void delta_writer_add(uint64_t prime, void *ctx);
+int delta_writer_close(DeltaWriter *w);
+int delta_decode(const char *path, PrimeCallback callback, void *ctx,
+                 uint64_t *count, uint64_t *limit);
+
+void print_prime(uint64_t prime, void *ctx);
+void timing_table(int threads);
+
+int main(int argc, char *argv[]) {
+    int threads = 1;
+    int print = 0;
+    const char *out_path = NULL;
+    const char *decode_path = NULL;
+    uint64_t limit = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-p") == 0) {
+            print = 1;
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            decode_path = argv[++i];
+        } else if (argv[i][0] != '-') {
+            limit = strtoull(argv[i], NULL, 10);
+        } else {
+            fprintf(stderr, "Usage: %s [-t threads] [-p] [-o file] [-d file] [limit]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (threads < 1) threads = 1;
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+
+    if (decode_path != NULL) {
+        uint64_t count = 0, file_limit = 0;
+        if (!delta_decode(decode_path, print ? print_prime : NULL, NULL, &count, &file_limit)) {
+            fprintf(stderr, "Could not read '%s' (missing or corrupt)\n", decode_path);
+            return 1;
+        }
+        if (print) {
+            printf("\n");
+        }
+        printf("%llu primes up to %llu in %s\n", (unsigned long long)count,
+               (unsigned long long)file_limit, decode_path);
+        return 0;
+    }
+
+    if (limit == 0) {
+        printf("Prime numbers from 1 to 100:\n");
+        sieve_each(100, 1, print_prime, NULL);
+        printf("\n");
+        timing_table(threads);
+        return 0;
+    }
+
+    clock_t start = clock();
+    if (out_path != NULL) {
+        DeltaWriter writer;
+        if (!delta_writer_open(&writer, out_path, limit)) {
+            fprintf(stderr, "Could not create '%s'\n", out_path);
+            return 1;
+        }
+        int ok = sieve_each(limit, threads, delta_writer_add, &writer);
+        if (!delta_writer_close(&writer) || !ok) {
+            fprintf(stderr, "Failed to write '%s'\n", out_path);
+            return 1;
+        }
+    } else if (print) {
+        if (!sieve_each(limit, threads, print_prime, NULL)) {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+        printf("\n");
+    } else {
+        uint64_t count = sieve_count(limit, threads);
+        if (count == UINT64_MAX) {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+        printf("%llu primes up to %llu\n", (unsigned long long)count, (unsigned long long)limit);
+    }
+    fprintf(stderr, "(%.2f s CPU)\n", (double)(clock() - start) / CLOCKS_PER_SEC);
+    return 0;
+}
+
+// --- Setup ---
+
+static uint64_t isqrt(uint64_t n) {
+    uint64_t r = 0;
+    for (uint64_t bit = (uint64_t)1 << 62; bit != 0; bit >>= 2) {
+        if (n >= r + bit) {
+            n -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+    }
+    return r;
+}
+
+// Sieving primes 7 <= p <= sqrt(limit), with each lane starting at p*k
+// for the smallest k >= p in that lane (smaller multiples were crossed
+// off by smaller primes). Returns 0 on allocation failure.
+int sieve_init(Sieve *sieve, uint64_t limit) {
+    for (int r = 0; r < 30; r++) {
+        wheel_bit[r] = -1;
+    }
+    for (int j = 0; j < 8; j++) {
+        wheel_bit[wheel_residues[j]] = (int8_t)j;
+    }
+
+    sieve->limit = limit;
+    sieve->total_bytes = limit / 30 + 1;
+    sieve->total_segments = (sieve->total_bytes + SEGMENT_BYTES - 1) / SEGMENT_BYTES;
+    sieve->prime_count = 0;
+
+    uint64_t root = isqrt(limit);
+    unsigned char *small = calloc(root + 1, 1);
+    sieve->primes = malloc((root / 2 + 1) * sizeof(SievePrime));
+    if (small == NULL || sieve->primes == NULL) {
+        free(small);
+        free(sieve->primes);
+        sieve->primes = NULL;
+        return 0;
+    }
+    for (uint64_t i = 2; i * i <= root; i++) {
+        if (!small[i]) {
+            for (uint64_t j = i * i; j <= root; j += i) {
+                small[j] = 1;
+            }
+        }
+    }
+    for (uint64_t p = 7; p <= root; p++) {
+        if (small[p]) {
+            continue;
+        }
+        SievePrime *sp = &sieve->primes[sieve->prime_count++];
+        sp->prime = p;
+        for (int j = 0; j < 8; j++) {
+            uint64_t k = p + (wheel_residues[j] + 30 - p % 30) % 30;
+            uint64_t n = p * k;
+            sp->next[j] = n / 30;
+            sp->mask[j] = (uint8_t)(1u << wheel_bit[n % 30]);
+        }
+    }
+    free(small);
+    return 1;
+}
+
+void sieve_free(Sieve *sieve) {
+    free(sieve->primes);
+    sieve->primes = NULL;
+}
+
+// --- Segment work ---
+
+// Sieve segment `seg` into buf (SEGMENT_BYTES). Set bits are composite.
+static void sieve_segment(const Sieve *sieve, SievePrime *primes, uint64_t seg, uint8_t *buf) {
+    uint64_t start = seg * SEGMENT_BYTES;
+    uint64_t end = start + SEGMENT_BYTES;
+    memset(buf, 0, SEGMENT_BYTES);
+    if (seg == 0) {
+        buf[0] |= 1;  // 1 is not prime
+    }
+
+    // Index the buffer by absolute byte number
+    uint8_t *base = buf - start;
+    for (size_t i = 0; i < sieve->prime_count; i++) {
+        SievePrime *sp = &primes[i];
+        uint64_t p = sp->prime;
+        for (int j = 0; j < 8; j++) {
+            uint64_t b = sp->next[j];
+            if (b < start) {
+                // This worker skipped ahead; jump the lane forward
+                b += (start - b + p - 1) / p * p;
+            }
+            uint8_t mask = sp->mask[j];
+            for (; b < end; b += p) {
+                base[b] |= mask;
+            }
+            sp->next[j] = b;
+        }
+    }
+
+    // Everything past the limit is "composite" so counting can ignore it
+    if (end > sieve->total_bytes) {
+        uint64_t last = sieve->total_bytes - 1;
+        unsigned rem = (unsigned)(sieve->limit % 30);
+        for (int j = 0; j < 8; j++) {
+            if (wheel_residues[j] > rem) {
+                base[last] |= (uint8_t)(1u << j);
+            }
+        }
+        memset(base + last + 1, 0xFF, end - last - 1);
+    }
+}
+
+static uint64_t count_segment(const uint8_t *buf) {
+    uint64_t composite = 0;
+    for (size_t i = 0; i < SEGMENT_BYTES; i += 8) {
+        uint64_t word;
+        memcpy(&word, buf + i, 8);
+        composite += (uint64_t)__builtin_popcountll(word);
+    }
+    return (uint64_t)SEGMENT_BYTES * 8 - composite;
+}
+
+static void emit_segment(uint64_t seg, const uint8_t *buf, PrimeCallback callback, void *ctx) {
+    uint64_t start = seg * SEGMENT_BYTES;
+    for (size_t i = 0; i < SEGMENT_BYTES; i++) {
+        unsigned bits = (uint8_t)~buf[i];
+        while (bits) {
+            int j = __builtin_ctz(bits);
+            bits &= bits - 1;
+            callback(30 * (start + i) + wheel_residues[j], ctx);
+        }
+    }
+}
+
+static void *worker_main(void *arg) {
+    Worker *w = arg;
+    for (uint64_t s = 0; s < w->seg_count; s++) {
+        uint8_t *buf = w->buffer + (w->do_count ? 0 : s * SEGMENT_BYTES);
+        sieve_segment(w->sieve, w->primes, w->first_segment + s, buf);
+        if (w->do_count) {
+            w->count += count_segment(buf);
+        }
+    }
+    return NULL;
+}
+
+// Run the sieve. Counting gives each thread one contiguous block of
+// segments. Emitting works in rounds of ROUND_SEGMENTS per thread so the
+// buffers stay small and the callback sees primes in increasing order.
+static int sieve_run(uint64_t limit, int threads, PrimeCallback callback, void *ctx,
+                     uint64_t *count_out) {
+    Sieve sieve;
+    if (!sieve_init(&sieve, limit)) {
+        return 0;
+    }
+    int do_count = callback == NULL;
+    uint64_t per_round = do_count
+        ? (sieve.total_segments + (uint64_t)threads - 1) / (uint64_t)threads
+        : ROUND_SEGMENTS;
+    size_t buffer_bytes = (size_t)(do_count ? 1 : per_round) * SEGMENT_BYTES;
+
+    Worker workers[MAX_THREADS];
+    int ok = 1;
+    for (int t = 0; t < threads; t++) {
+        workers[t].sieve = &sieve;
+        workers[t].primes = malloc(sieve.prime_count * sizeof(SievePrime) + 1);
+        workers[t].buffer = malloc(buffer_bytes);
+        workers[t].count = 0;
+        workers[t].do_count = do_count;
+        if (workers[t].primes == NULL || workers[t].buffer == NULL) {
+            ok = 0;
+        } else {
+            memcpy(workers[t].primes, sieve.primes, sieve.prime_count * sizeof(SievePrime));
+        }
+    }
+
+    // 2, 3 and 5 are not on the wheel
+    uint64_t count = 0;
+    for (uint64_t p = 2; ok && p <= 5 && p <= limit; p += (p == 2) ? 1 : 2) {
+        if (callback) {
+            callback(p, ctx);
+        }
+        count++;
+    }
+
+    for (uint64_t seg = 0; ok && seg < sieve.total_segments; seg += per_round * (uint64_t)threads) {
+        pthread_t tids[MAX_THREADS];
+        int started[MAX_THREADS];
+        for (int t = 0; t < threads; t++) {
+            Worker *w = &workers[t];
+            w->first_segment = seg + (uint64_t)t * per_round;
+            uint64_t left = w->first_segment < sieve.total_segments
+                            ? sieve.total_segments - w->first_segment : 0;
+            w->seg_count = left < per_round ? left : per_round;
+            started[t] = t > 0 && pthread_create(&tids[t], NULL, worker_main, w) == 0;
+        }
+        // This thread does worker 0, plus any that failed to start
+        for (int t = 0; t < threads; t++) {
+            if (!started[t]) {
+                worker_main(&workers[t]);
+            }
+        }
+        for (int t = 1; t < threads; t++) {
+            if (started[t]) {
+                pthread_join(tids[t], NULL);
+            }
+        }
+        if (!do_count) {
+            for (int t = 0; t < threads; t++) {
+                for (uint64_t s = 0; s < workers[t].seg_count; s++) {
+                    emit_segment(workers[t].first_segment + s,
+                                 workers[t].buffer + s * SEGMENT_BYTES, callback, ctx);
+                }
+            }
+        }
+    }
+
+    for (int t = 0; t < threads; t++) {
+        count += workers[t].count;
+        free(workers[t].primes);
+        free(workers[t].buffer);
+    }
+    sieve_free(&sieve);
+    if (count_out != NULL) {
+        *count_out = count;
+    }
+    return ok;
+}
+
+// Number of primes <= limit, or UINT64_MAX if memory ran out
+uint64_t sieve_count(uint64_t limit, int threads) {
+    uint64_t count;
+    return sieve_run(limit, threads, NULL, NULL, &count) ? count : UINT64_MAX;
+}
+
+// Call callback(p, ctx) for every prime p <= limit, in increasing order
+int sieve_each(uint64_t limit, int threads, PrimeCallback callback, void *ctx) {
+    return sieve_run(limit, threads, callback, ctx, NULL);
+}
+
+// --- Delta-encoded files ---
+// Layout: "PRIMEDL1", limit (8 bytes, little-endian), then for each odd
+// prime p (the 2 is implied) the varint of (p - previous) / 2, starting
+// from previous = 1. Varints are LEB128: 7 bits per byte, high bit set
+// on all but the last byte. Gaps below 256 - nearly all of them - take
+// one byte per prime.
+
+static void delta_flush(DeltaWriter *w) {
+    if (w->used > 0 && fwrite(w->buf, 1, w->used, w->out) != w->used) {
+        w->ok = 0;
+    }
+    w->used = 0;
+}
+
+int delta_writer_open(DeltaWriter *w, const char *path, uint64_t limit) {
+    w->out = fopen(path, "wb");
+    if (w->out == NULL) {
+        return 0;
+    }
+    w->prev = 1;
+    w->used = 0;
+    w->ok = 1;
+    memcpy(w->buf, DELTA_MAGIC, 8);
+    for (int i = 0; i < 8; i++) {
+        w->buf[8 + i] = (unsigned char)(limit >> (8 * i));
+    }
+    w->used = 16;
+    return 1;
+}
+
+void delta_writer_add(uint64_t prime, void *ctx) {
+    DeltaWriter *w = ctx;
+    if (prime == 2) {
+        return;
+    }
+    if (w->used + 10 > sizeof(w->buf)) {
+        delta_flush(w);
+    }
+    uint64_t v = (prime - w->prev) / 2;
+    w->prev = prime;
+    while (v >= 0x80) {
+        w->buf[w->used++] = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    w->buf[w->used++] = (unsigned char)v;
+}
+
+int delta_writer_close(DeltaWriter *w) {
+    delta_flush(w);
+    if (fclose(w->out) != 0) {
+        w->ok = 0;
+    }
+    return w->ok;
+}
+
+// Decode a file, calling callback(prime, ctx) for each prime (if not
+// NULL). Returns 0 if the file is missing or corrupt.
+int delta_decode(const char *path, PrimeCallback callback, void *ctx,
+                 uint64_t *count, uint64_t *limit) {
+    FILE *in = fopen(path, "rb");
+    if (in == NULL) {
+        return 0;
+    }
+    unsigned char header[16];
+    if (fread(header, 1, 16, in) != 16 || memcmp(header, DELTA_MAGIC, 8) != 0) {
+        fclose(in);
+        return 0;
+    }
+    *limit = 0;
+    for (int i = 0; i < 8; i++) {
+        *limit |= (uint64_t)header[8 + i] << (8 * i);
+    }
+
+    *count = 0;
+    if (*limit >= 2) {
+        (*count)++;
+        if (callback) callback(2, ctx);
+    }
+    uint64_t prev = 1, v = 0;
+    int shift = 0;
+    unsigned char buf[65536];
+    size_t got;
+    while ((got = fread(buf, 1, sizeof(buf), in)) > 0) {
+        for (size_t i = 0; i < got; i++) {
+            v |= (uint64_t)(buf[i] & 0x7F) << shift;
+            if (buf[i] & 0x80) {
+                shift += 7;
+                if (shift > 63) {
+                    // More continuation bytes than a 64-bit gap needs
+                    fclose(in);
+                    return 0;
+                }
+                continue;
+            }
+            prev += 2 * v;
+            (*count)++;
+            if (callback) callback(prev, ctx);
+            v = 0;
+            shift = 0;
+        }
+    }
+    // A read error, or a file cut off in the middle of a gap, is corrupt
+    int ok = !ferror(in) && shift == 0;
+    fclose(in);
+    return ok;
+}
+
+// --- Output ---
+
+// Buffered decimal printing; printf per prime would dominate the run time
+void print_prime(uint64_t prime, void *ctx) {
+    (void)ctx;
+    char digits[24];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + prime % 10);
+        prime /= 10;
+    } while (prime > 0);
+    char line[26];
+    int len = 0;
+    while (n > 0) {
+        line[len++] = digits[--n];
+    }
+    line[len++] = ' ';
+    fwrite(line, 1, (size_t)len, stdout);
+}
+
+// --- Timing table ---
+
+static double seconds_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void timing_table(int threads) {
+    // pi(10^k), the number of primes up to 10^k
+    static const uint64_t known[] = {
+        0, 4, 25, 168, 1229, 9592, 78498, 664579, 5761455, 50847534,
+    };
+    printf("\n=== Prime counts (%d thread%s) ===\n", threads, threads == 1 ? "" : "s");
+    printf("%14s %12s %10s\n", "limit", "primes", "time (ms)");
+    uint64_t limit = 1;
+    for (int k = 1; k <= 9; k++) {
+        limit *= 10;
+        double t0 = seconds_now();
+        uint64_t count = sieve_count(limit, threads);
+        double ms = (seconds_now() - t0) * 1e3;
+        printf("%14llu %12llu %10.1f%s\n", (unsigned long long)limit,
+               (unsigned long long)count, ms, count == known[k] ? "" : "  WRONG");
+    }
+}
@@ -0,0 +1,486 @@
+/*
+ * Exercise 3.5: Fast Primality Testing (Miller-Rabin)
+ *
+ * Trial division (Exercise 3.2) needs up to sqrt(n) divisions - about
+ * 4 billion for a 64-bit n. Miller-Rabin needs a handful of modular
+ * exponentiations instead.
+ *
+ * Write n - 1 = d * 2^s with d odd. For a prime n and any base a, the
+ * sequence a^d, a^2d, a^4d, ..., a^(n-1) (mod n) either starts at 1 or
+ * hits n - 1 somewhere (Fermat's little theorem plus "the only square
+ * roots of 1 mod a prime are 1 and -1"). A composite n fails this for
+ * most bases, and for every n < 2^64 it is known that these 7 bases
+ * catch all composites:
+ *     2, 325, 9375, 28178, 450775, 9780504, 1795265022
+ * so the test is exact, not probabilistic.
+ *
+ * To make it fast:
+ *   - Most numbers have a small factor, so divide by small primes first.
+ *     "n % p == 0" becomes a multiply and compare: for odd p,
+ *     n * inverse(p) mod 2^64 <= (2^64 - 1) / p exactly when p divides n.
+ *   - Multiplying mod n uses Montgomery form, which replaces the slow
+ *     128-by-64-bit division with two multiplies.
+ *   - The batch API interleaves 4 exponentiations so the CPU can overlap
+ *     their multiplies instead of waiting on each one in turn. That pays
+ *     off when many inputs reach the full test (a list of valid IDs is
+ *     mostly primes); random inputs rarely get past base 2 anyway.
+ *
+ * Python equivalent:
+ *   def is_prime(n):
+ *       if n < 2: return False
+ *       for p in SMALL_PRIMES:
+ *           if n % p == 0: return n == p
+ *       d, s = n - 1, 0
+ *       while d % 2 == 0: d, s = d // 2, s + 1
+ *       for a in (2, 325, 9375, 28178, 450775, 9780504, 1795265022):
+ *           x = pow(a, d, n)
+ *           if a % n == 0 or x in (1, n - 1): continue
+ *           for _ in range(s - 1):
+ *               x = x * x % n
+ *               if x == n - 1: break
+ *           else:
+ *               return False
+ *       return True
+ *
+ * Compile: cc -Wall -O2 -o ex05_miller_rabin ex05_miller_rabin.c
+ * Run: ./ex05_miller_rabin [numbers...]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#define SMALL_PRIME_COUNT 31     // Odd primes 3..131
+#define BATCH_LANES 4
+#define BENCH_COUNT 1000000
+
+typedef unsigned __int128 u128;
+
+// Divisibility test by multiply: n % p == 0  <=>  n * inv <= limit
+typedef struct {
+    uint64_t prime;
+    uint64_t inv;    // p^-1 mod 2^64
+    uint64_t limit;  // UINT64_MAX / p
+} SmallPrime;
+
+// Montgomery arithmetic mod an odd n, with R = 2^64
+typedef struct {
+    uint64_t n;
+    uint64_t inv;     // n^-1 mod 2^64
+    uint64_t one;     // R mod n (1 in Montgomery form)
+    uint64_t r2;      // R^2 mod n (converts into Montgomery form), 0 until needed
+} Montgomery;
+
+static const uint64_t witnesses[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+#define WITNESS_COUNT (sizeof(witnesses) / sizeof(witnesses[0]))
+
+static SmallPrime small_primes[SMALL_PRIME_COUNT];
+
+// Function prototypes
+void init_small_primes(void);
+int is_prime_trial(uint64_t n);
+int is_prime(uint64_t n);
+size_t is_prime_batch(const uint64_t *values, size_t count, uint8_t *out);
+
+int verify(void);
+void benchmark(void);
+
+int main(int argc, char *argv[]) {
+    init_small_primes();
+
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            uint64_t n = strtoull(argv[i], NULL, 10);
+            printf("%llu is %s\n", (unsigned long long)n, is_prime(n) ? "prime" : "composite");
+        }
+        return 0;
+    }
+
+    printf("Prime numbers from 1 to 100:\n");
+    for (uint64_t n = 1; n <= 100; n++) {
+        if (is_prime(n)) {
+            printf("%llu ", (unsigned long long)n);
+        }
+    }
+    printf("\n");
+
+    if (!verify()) {
+        return 1;
+    }
+    benchmark();
+    return 0;
+}
+
+// --- Small-prime prefilter ---
+
+static uint64_t inverse_mod_2_64(uint64_t a) {
+    // Newton's iteration: each step doubles the number of correct bits.
+    // a * a == 1 (mod 8) for odd a, so x = a starts with 3 good bits.
+    uint64_t x = a;
+    for (int i = 0; i < 5; i++) {
+        x *= 2 - a * x;
+    }
+    return x;
+}
+
+void init_small_primes(void) {
+    int count = 0;
+    for (uint64_t p = 3; count < SMALL_PRIME_COUNT; p += 2) {
+        int prime = 1;
+        for (uint64_t q = 3; q * q <= p; q += 2) {
+            if (p % q == 0) {
+                prime = 0;
+                break;
+            }
+        }
+        if (prime) {
+            small_primes[count].prime = p;
+            small_primes[count].inv = inverse_mod_2_64(p);
+            small_primes[count].limit = UINT64_MAX / p;
+            count++;
+        }
+    }
+}
+
+// Returns 1 (prime), 0 (composite), or -1 (no small factor: run the test)
+static int prefilter(uint64_t n) {
+    if (n < 2) return 0;
+    if ((n & 1) == 0) return n == 2;
+    for (int i = 0; i < SMALL_PRIME_COUNT; i++) {
+        if (n * small_primes[i].inv <= small_primes[i].limit) {
+            return n == small_primes[i].prime;
+        }
+    }
+    // No factor up to the last small prime p means prime if n < p^2
+    uint64_t last = small_primes[SMALL_PRIME_COUNT - 1].prime;
+    return n < last * last ? 1 : -1;
+}
+
+// The Exercise 3.2 approach, for comparison
+int is_prime_trial(uint64_t n) {
+    if (n < 2) return 0;
+    if (n % 2 == 0) return n == 2;
+    for (uint64_t i = 3; i <= n / i; i += 2) {
+        if (n % i == 0) return 0;
+    }
+    return 1;
+}
+
+// --- Montgomery arithmetic ---
+
+static void mont_init(Montgomery *m, uint64_t n) {
+    m->n = n;
+    m->inv = inverse_mod_2_64(n);
+    m->one = (0 - n) % n;                    // 2^64 mod n
+    m->r2 = 0;
+}
+
+// a * b / R mod n, for a, b < n. The low halves of t and m*n are equal
+// by construction, so only the high halves need subtracting.
+static inline uint64_t mont_mul(const Montgomery *m, uint64_t a, uint64_t b) {
+    u128 t = (u128)a * b;
+    uint64_t q = (uint64_t)t * m->inv;
+    uint64_t qn_hi = (uint64_t)(((u128)q * m->n) >> 64);
+    uint64_t t_hi = (uint64_t)(t >> 64);
+    uint64_t r = t_hi - qn_hi;
+    return t_hi < qn_hi ? r + m->n : r;
+}
+
+// R^2 mod n costs a 128-bit division, and base 2 (which most composites
+// fail) never needs it, so it is computed on first use
+static inline uint64_t mont_to(Montgomery *m, uint64_t a) {
+    if (m->r2 == 0) {
+        m->r2 = (uint64_t)((u128)m->one * m->one % m->n);
+    }
+    return mont_mul(m, a % m->n, m->r2);
+}
+
+// 2x mod n without a multiply; base 2 is the first witness, and the one
+// almost every composite fails, so its exponentiation gets this shortcut
+static inline uint64_t mont_double(const Montgomery *m, uint64_t x) {
+    uint64_t gap = m->n - x;
+    return x >= gap ? x - gap : x + x;
+}
+
+// One Miller-Rabin round for base 0 < a < n
+static int mr_round(Montgomery *m, uint64_t a, uint64_t d, int s) {
+    uint64_t minus_one = m->n - m->one;      // n - 1 in Montgomery form
+    uint64_t x = m->one;
+    uint64_t am = a == 2 ? 0 : mont_to(m, a);
+    for (int bit = 63 - __builtin_clzll(d); bit >= 0; bit--) {
+        x = mont_mul(m, x, x);
+        if ((d >> bit) & 1) {
+            x = a == 2 ? mont_double(m, x) : mont_mul(m, x, am);
+        }
+    }
+    if (x == m->one || x == minus_one) {
+        return 1;
+    }
+    for (int i = 1; i < s; i++) {
+        x = mont_mul(m, x, x);
+        if (x == minus_one) return 1;
+        if (x == m->one) return 0;
+    }
+    return 0;
+}
+
+// Miller-Rabin for an odd n with no small factors
+static int miller_rabin(uint64_t n) {
+    Montgomery m;
+    mont_init(&m, n);
+    uint64_t d = n - 1;
+    int s = __builtin_ctzll(d);
+    d >>= s;
+
+    for (size_t i = 0; i < WITNESS_COUNT; i++) {
+        uint64_t a = witnesses[i] % n;
+        if (a == 0) {
+            continue;
+        }
+        if (!mr_round(&m, a, d, s)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int is_prime(uint64_t n) {
+    int r = prefilter(n);
+    return r >= 0 ? r : miller_rabin(n);
+}
+
+// --- Batch API ---
+
+// Runs the exponentiation a^d for BATCH_LANES numbers side by side.
+// Lanes with shorter exponents see leading zero bits, which only square
+// 1 (in Montgomery form) until their own top bit arrives.
+static void mr_batch_lanes(const uint64_t *n, uint8_t *out) {
+    Montgomery m[BATCH_LANES];
+    uint64_t d[BATCH_LANES], x[BATCH_LANES], a[BATCH_LANES];
+    int s[BATCH_LANES], alive[BATCH_LANES];
+    int top = 0;
+
+    for (int l = 0; l < BATCH_LANES; l++) {
+        mont_init(&m[l], n[l]);
+        d[l] = n[l] - 1;
+        s[l] = __builtin_ctzll(d[l]);
+        d[l] >>= s[l];
+        alive[l] = 1;
+        int bits = 64 - __builtin_clzll(d[l]);
+        if (bits > top) top = bits;
+    }
+
+    for (size_t w = 0; w < WITNESS_COUNT; w++) {
+        for (int l = 0; l < BATCH_LANES; l++) {
+            uint64_t base = witnesses[w] % n[l];
+            // A zero base is skipped; 1 passes trivially and keeps lanes in step
+            a[l] = (w == 0 || base == 0) ? m[l].one : mont_to(&m[l], base);
+            x[l] = m[l].one;
+        }
+        if (w == 0) {
+            for (int bit = top - 1; bit >= 0; bit--) {
+                for (int l = 0; l < BATCH_LANES; l++) {
+                    uint64_t sq = mont_mul(&m[l], x[l], x[l]);
+                    uint64_t by_a = mont_double(&m[l], sq);
+                    x[l] = ((d[l] >> bit) & 1) ? by_a : sq;
+                }
+            }
+        } else {
+            for (int bit = top - 1; bit >= 0; bit--) {
+                for (int l = 0; l < BATCH_LANES; l++) {
+                    uint64_t sq = mont_mul(&m[l], x[l], x[l]);
+                    uint64_t by_a = mont_mul(&m[l], sq, a[l]);
+                    x[l] = ((d[l] >> bit) & 1) ? by_a : sq;
+                }
+            }
+        }
+        // The squaring chain is short (s is 1 for half of all n): do it per lane
+        int any_alive = 0;
+        for (int l = 0; l < BATCH_LANES; l++) {
+            if (!alive[l]) continue;
+            uint64_t minus_one = m[l].n - m[l].one;
+            int pass = x[l] == m[l].one || x[l] == minus_one;
+            for (int i = 1; i < s[l] && !pass; i++) {
+                x[l] = mont_mul(&m[l], x[l], x[l]);
+                if (x[l] == minus_one) pass = 1;
+                else if (x[l] == m[l].one) break;
+            }
+            alive[l] = pass;
+            any_alive |= pass;
+        }
+        if (!any_alive) break;
+    }
+    for (int l = 0; l < BATCH_LANES; l++) {
+        out[l] = (uint8_t)alive[l];
+    }
+}
+
+// out[i] = 1 if values[i] is prime, else 0. Returns the number of primes.
+// The prefilter runs first; survivors are tested BATCH_LANES at a time.
+size_t is_prime_batch(const uint64_t *values, size_t count, uint8_t *out) {
+    size_t pending[BATCH_LANES];
+    uint64_t lane_n[BATCH_LANES];
+    uint8_t lane_out[BATCH_LANES];
+    int used = 0;
+    size_t primes = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        int r = prefilter(values[i]);
+        out[i] = (uint8_t)(r > 0);
+        if (r >= 0) {
+            primes += (size_t)r;
+            continue;
+        }
+        pending[used] = i;
+        lane_n[used] = values[i];
+        if (++used == BATCH_LANES) {
+            mr_batch_lanes(lane_n, lane_out);
+            for (int l = 0; l < BATCH_LANES; l++) {
+                out[pending[l]] = lane_out[l];
+                primes += lane_out[l];
+            }
+            used = 0;
+        }
+    }
+    for (int l = 0; l < used; l++) {
+        out[pending[l]] = (uint8_t)miller_rabin(lane_n[l]);
+        primes += out[pending[l]];
+    }
+    return primes;
+}
+
+// --- Verification ---
+
+int verify(void) {
+    // Every n below 2^22 against a sieve
+    const uint64_t limit = 1u << 22;
+    uint8_t *sieve = malloc(limit);
+    uint64_t *values = malloc(limit * sizeof(uint64_t));
+    uint8_t *batch = malloc(limit);
+    if (sieve == NULL || values == NULL || batch == NULL) {
+        free(sieve);
+        free(values);
+        free(batch);
+        fprintf(stderr, "Out of memory\n");
+        return 0;
+    }
+    memset(sieve, 1, limit);
+    sieve[0] = sieve[1] = 0;
+    for (uint64_t i = 2; i * i < limit; i++) {
+        if (sieve[i]) {
+            for (uint64_t j = i * i; j < limit; j += i) sieve[j] = 0;
+        }
+    }
+    for (uint64_t i = 0; i < limit; i++) {
+        values[i] = i;
+    }
+    is_prime_batch(values, limit, batch);
+    size_t bad = 0;
+    for (uint64_t i = 0; i < limit; i++) {
+        if (is_prime(i) != sieve[i] || batch[i] != sieve[i]) bad++;
+    }
+
+    // Strong pseudoprimes that fool smaller base sets, and big primes
+    static const struct { uint64_t n; int prime; } cases[] = {
+        {2047, 0},                    // 23 * 89, fools base 2
+        {3215031751ULL, 0},           // Fools bases 2, 3, 5, 7
+        {4759123141ULL, 0},           // 48781 * 97561, fools bases 2, 7, 61
+        {1122004669633ULL, 0},        // Fools bases 2, 13, 23, 1662803
+        {3825123056546413051ULL, 0},  // Fools every prime base up to 23
+        {4611686014132420609ULL, 0},  // (2^31 - 1)^2
+        {2305843009213693951ULL, 1},  // 2^61 - 1
+        {18446744073709551557ULL, 1}, // Largest 64-bit prime
+        {18446744073709551615ULL, 0}, // 2^64 - 1
+        {18446744030759878681ULL, 0}, // 4294967291 * 4294967291
+        {18446743979220271189ULL, 0}, // 4294967279 * 4294967291
+    };
+    size_t ncases = sizeof(cases) / sizeof(cases[0]);
+    uint64_t case_values[16];
+    uint8_t case_batch[16];
+    for (size_t i = 0; i < ncases; i++) {
+        case_values[i] = cases[i].n;
+    }
+    is_prime_batch(case_values, ncases, case_batch);
+    for (size_t i = 0; i < ncases; i++) {
+        if (is_prime(cases[i].n) != cases[i].prime || case_batch[i] != cases[i].prime) {
+            printf("Wrong answer for %llu\n", (unsigned long long)cases[i].n);
+            bad++;
+        }
+    }
+
+    printf("\nChecked n < %llu against a sieve and %zu special cases: %s\n",
+           (unsigned long long)limit, ncases, bad == 0 ? "all correct" : "MISMATCH");
+    free(sieve);
+    free(values);
+    free(batch);
+    return bad == 0;
+}
+
+// --- Benchmark ---
+
+static uint64_t xorshift64(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+static double checks_per_second(size_t count, clock_t start) {
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    return seconds > 0 ? count / seconds : 0;
+}
+
+void benchmark(void) {
+    uint64_t *values = malloc(BENCH_COUNT * sizeof(uint64_t));
+    uint8_t *out = malloc(BENCH_COUNT);
+    if (values == NULL || out == NULL) {
+        free(values);
+        free(out);
+        return;
+    }
+
+    printf("\n=== Benchmark (%d numbers, checks per second) ===\n", BENCH_COUNT);
+    printf("%-22s %14s %14s %14s\n", "input", "trial", "is_prime", "batch");
+
+    const char *labels[] = {"random 32-bit", "random 64-bit", "64-bit primes only"};
+    uint64_t state = 88172645463325252ULL;
+    for (int kind = 0; kind < 3; kind++) {
+        for (size_t i = 0; i < BENCH_COUNT; i++) {
+            uint64_t v = xorshift64(&state);
+            if (kind == 0) {
+                v >>= 32;
+            } else if (kind == 2) {
+                v |= 1;
+                while (!is_prime(v)) v += 2;
+            }
+            values[i] = v;
+        }
+
+        // Trial division on 64-bit inputs can take seconds per number
+        char trial[32] = "-";
+        if (kind == 0) {
+            clock_t start = clock();
+            size_t found = 0;
+            for (size_t i = 0; i < BENCH_COUNT; i++) found += (size_t)is_prime_trial(values[i]);
+            snprintf(trial, sizeof(trial), "%.0f", checks_per_second(BENCH_COUNT, start));
+            (void)found;
+        }
+
+        clock_t start = clock();
+        size_t single = 0;
+        for (size_t i = 0; i < BENCH_COUNT; i++) single += (size_t)is_prime(values[i]);
+        double single_rate = checks_per_second(BENCH_COUNT, start);
+
+        start = clock();
+        size_t batched = is_prime_batch(values, BENCH_COUNT, out);
+        double batch_rate = checks_per_second(BENCH_COUNT, start);
+
+        printf("%-22s %14s %14.0f %14.0f%s\n", labels[kind], trial, single_rate, batch_rate,
+               single == batched ? "" : "  MISMATCH");
+    }
+    free(values);
+    free(out);
+}
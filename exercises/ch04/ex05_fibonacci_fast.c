@@ -0,0 +1,370 @@
+/*
+ * Exercise 4.5: Fast Fibonacci with Big Numbers
+ *
+ * Exercise 4.3 compares fib_recursive (exponential time) with
+ * fib_iterative (linear time), both returning a long - which overflows
+ * after F(92). This version goes further:
+ *
+ *   - BigNum results (../common/bignum.c), so F(1000000) with its
+ *     208988 digits is no problem - Python ints do this for you.
+ *   - Fast doubling, O(log n) steps instead of n:
+ *       F(2k)   = F(k) * (2*F(k+1) - F(k))
+ *       F(2k+1) = F(k)^2 + F(k+1)^2
+ *     Each step halves n, so F(1000000) takes 20 steps (of big
+ *     multiplications, which is where Karatsuba pays off).
+ *   - A memoized recursive version of the same identities, with a cache
+ *     that is kept between calls so repeated queries are instant.
+ *
+ * Python equivalent:
+ *   from functools import lru_cache
+ *   @lru_cache(maxsize=None)
+ *   def fib(n): ...
+ *
+ * Compile: cc -Wall -O2 -o ex05_fibonacci_fast ex05_fibonacci_fast.c ../common/bignum.c
+ * Run: ./ex05_fibonacci_fast
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "../common/bignum.h"
+
+// Cache of F(n) values for fib_memo, kept across queries
+typedef struct {
+    uint64_t key;
+    int used;
+    BigNum value;
+} FibEntry;
+
+typedef struct {
+    FibEntry *entries;
+    size_t capacity;  // Power of two
+    size_t count;
+} FibCache;
+
+// Function prototypes
+long fib_recursive(int n);
+uint64_t fib_iterative(int n);  // Exact up to F(93)
+int fib_iterative_big(uint64_t n, BigNum *out);
+int fib_fast_doubling(uint64_t n, BigNum *out);
+
+void fib_cache_init(FibCache *cache);
+void fib_cache_free(FibCache *cache);
+int fib_memo(FibCache *cache, uint64_t n, BigNum *out);
+
+void print_bignum_summary(const char *label, const BigNum *value);
+void comparison_table(void);
+
+int main(void) {
+    printf("First 20 Fibonacci numbers:\n");
+    for (int i = 0; i < 20; i++) {
+        printf("%llu ", (unsigned long long)fib_iterative(i));
+    }
+    printf("\n\n");
+
+    printf("F(93) = %llu (largest that fits in 64 bits)\n",
+           (unsigned long long)fib_iterative(93));
+
+    BigNum f;
+    bn_init(&f);
+    if (!fib_fast_doubling(100, &f)) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    char *text = bn_to_string(&f);
+    printf("F(100) = %s\n", text ? text : "?");
+    free(text);
+
+    if (!fib_fast_doubling(1000000, &f)) {
+        fprintf(stderr, "Out of memory\n");
+        bn_free(&f);
+        return 1;
+    }
+    print_bignum_summary("F(1000000)", &f);
+    bn_free(&f);
+
+    comparison_table();
+    return 0;
+}
+
+// --- Exercise 4.3 versions ---
+
+long fib_recursive(int n) {
+    if (n < 2) {
+        return n;
+    }
+    return fib_recursive(n - 1) + fib_recursive(n - 2);
+}
+
+uint64_t fib_iterative(int n) {
+    uint64_t a = 0, b = 1;
+    for (int i = 0; i < n; i++) {
+        uint64_t next = a + b;
+        a = b;
+        b = next;
+    }
+    return a;
+}
+
+// Same loop with BigNum: n additions of growing numbers, so O(n^2) overall
+int fib_iterative_big(uint64_t n, BigNum *out) {
+    BigNum a, b;
+    bn_init(&a);
+    bn_init(&b);
+    int ok = bn_set_u64(&a, 0) && bn_set_u64(&b, 1);
+    for (uint64_t i = 0; ok && i < n; i++) {
+        ok = bn_add(&a, &a, &b);
+        bn_swap(&a, &b);
+    }
+    ok = ok && bn_copy(out, &a);
+    bn_free(&a);
+    bn_free(&b);
+    return ok;
+}
+
+// --- Fast doubling ---
+
+// Walk the bits of n from the top. (a, b) = (F(k), F(k+1)); each bit
+// doubles k, and a 1 bit also adds one.
+int fib_fast_doubling(uint64_t n, BigNum *out) {
+    BigNum a, b, t, c, d;
+    bn_init(&a);
+    bn_init(&b);
+    bn_init(&t);
+    bn_init(&c);
+    bn_init(&d);
+    int ok = bn_set_u64(&a, 0) && bn_set_u64(&b, 1);
+
+    int bit = 63;
+    while (bit >= 0 && !((n >> bit) & 1)) {
+        bit--;
+    }
+    for (; ok && bit >= 0; bit--) {
+        int one = (n >> bit) & 1;
+        // The last step only needs F(n), not F(n+1): skip the products
+        // for the unused half. It is the most expensive step, with the
+        // largest numbers, so this saves about a third of the total.
+        if (bit == 0) {
+            ok = one ? bn_mul(&t, &a, &a) && bn_mul(&b, &b, &b) && bn_add(&a, &t, &b)
+                     : bn_add(&t, &b, &b) && bn_sub(&t, &t, &a) && bn_mul(&a, &a, &t);
+            break;
+        }
+        // c = F(2k) = a * (2b - a);  d = F(2k+1) = a^2 + b^2
+        ok = bn_add(&t, &b, &b)
+             && bn_sub(&t, &t, &a)
+             && bn_mul(&c, &a, &t)
+             && bn_mul(&a, &a, &a)
+             && bn_mul(&b, &b, &b)
+             && bn_add(&d, &a, &b);
+        if (!ok) {
+            break;
+        }
+        if (one) {
+            // (F(2k+1), F(2k+2)) = (d, c + d)
+            ok = bn_add(&c, &c, &d);
+            bn_swap(&a, &d);
+            bn_swap(&b, &c);
+        } else {
+            bn_swap(&a, &c);
+            bn_swap(&b, &d);
+        }
+    }
+
+    ok = ok && bn_copy(out, &a);
+    bn_free(&a);
+    bn_free(&b);
+    bn_free(&t);
+    bn_free(&c);
+    bn_free(&d);
+    return ok;
+}
+
+// --- Memoized recursion ---
+
+void fib_cache_init(FibCache *cache) {
+    cache->entries = NULL;
+    cache->capacity = 0;
+    cache->count = 0;
+}
+
+void fib_cache_free(FibCache *cache) {
+    for (size_t i = 0; i < cache->capacity; i++) {
+        if (cache->entries[i].used) {
+            bn_free(&cache->entries[i].value);
+        }
+    }
+    free(cache->entries);
+    fib_cache_init(cache);
+}
+
+static size_t cache_slot(const FibCache *cache, uint64_t key) {
+    size_t mask = cache->capacity - 1;
+    size_t i = (size_t)(key * 0x9E3779B97F4A7C15ULL >> 32) & mask;
+    while (cache->entries[i].used && cache->entries[i].key != key) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+// Linear probing; grow at half full. Entries move on growth, so callers
+// copy values out rather than holding pointers into the table.
+static int cache_store(FibCache *cache, uint64_t key, const BigNum *value) {
+    if (2 * (cache->count + 1) > cache->capacity) {
+        size_t old_capacity = cache->capacity;
+        FibEntry *old = cache->entries;
+        size_t capacity = old_capacity ? old_capacity * 2 : 64;
+        FibEntry *entries = calloc(capacity, sizeof(FibEntry));
+        if (entries == NULL) {
+            return 0;
+        }
+        cache->entries = entries;
+        cache->capacity = capacity;
+        for (size_t i = 0; i < old_capacity; i++) {
+            if (old[i].used) {
+                cache->entries[cache_slot(cache, old[i].key)] = old[i];
+            }
+        }
+        free(old);
+    }
+    FibEntry *e = &cache->entries[cache_slot(cache, key)];
+    if (!e->used) {
+        e->used = 1;
+        e->key = key;
+        bn_init(&e->value);
+        cache->count++;
+    }
+    return bn_copy(&e->value, value);
+}
+
+// F(n) from F(n/2) and F(n/2 + 1), each looked up or computed and stored.
+// Only O(log n) distinct values are ever needed per query.
+int fib_memo(FibCache *cache, uint64_t n, BigNum *out) {
+    // F(0), F(1), F(2); F(2) is a base case because it would need F(1 + 1)
+    if (n <= 2) {
+        return bn_set_u64(out, n != 0);
+    }
+    if (cache->capacity > 0) {
+        FibEntry *e = &cache->entries[cache_slot(cache, n)];
+        if (e->used) {
+            return bn_copy(out, &e->value);
+        }
+    }
+
+    uint64_t k = n / 2;
+    BigNum a, b, t;
+    bn_init(&a);
+    bn_init(&b);
+    bn_init(&t);
+    int ok = fib_memo(cache, k, &a) && fib_memo(cache, k + 1, &b);
+    if (ok && n % 2 == 0) {
+        // F(2k) = F(k) * (2*F(k+1) - F(k))
+        ok = bn_add(&t, &b, &b) && bn_sub(&t, &t, &a) && bn_mul(out, &a, &t);
+    } else if (ok) {
+        // F(2k+1) = F(k)^2 + F(k+1)^2
+        ok = bn_mul(&t, &a, &a) && bn_mul(&b, &b, &b) && bn_add(out, &t, &b);
+    }
+    ok = ok && cache_store(cache, n, out);
+    bn_free(&a);
+    bn_free(&b);
+    bn_free(&t);
+    return ok;
+}
+
+// --- Output ---
+
+void print_bignum_summary(const char *label, const BigNum *value) {
+    clock_t start = clock();
+    char *text = bn_to_string(value);
+    clock_t end = clock();
+    if (text == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return;
+    }
+    size_t digits = strlen(text);
+    printf("%s has %zu digits: %.20s...%s (to decimal: %.1f ms)\n",
+           label, digits, text, digits > 20 ? text + digits - 20 : "",
+           (double)(end - start) * 1000.0 / CLOCKS_PER_SEC);
+    free(text);
+}
+
+// --- Comparison table ---
+
+#define METHOD_COUNT 6
+
+static const char *method_names[METHOD_COUNT] = {
+    "recursive", "iterative", "iter. bignum", "memo (cold)", "memo (warm)", "fast doubling",
+};
+
+// Largest n each method is run for; beyond that it is too slow or overflows
+static const uint64_t method_limit[METHOD_COUNT] = {
+    35, 93, 100000, 10000000, 10000000, 10000000,
+};
+
+static double elapsed_ms(clock_t start, clock_t end) {
+    return (double)(end - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+void comparison_table(void) {
+    const uint64_t sizes[] = {30, 90, 1000, 10000, 100000, 1000000, 10000000};
+    const int size_count = sizeof(sizes) / sizeof(sizes[0]);
+
+    printf("\n=== Comparison (milliseconds, '-' = not run) ===\n");
+    printf("%10s %10s", "n", "bits");
+    for (int m = 0; m < METHOD_COUNT; m++) {
+        printf(" %13s", method_names[m]);
+    }
+    printf("\n");
+
+    BigNum reference, result;
+    bn_init(&reference);
+    bn_init(&result);
+
+    for (int s = 0; s < size_count; s++) {
+        uint64_t n = sizes[s];
+        if (!fib_fast_doubling(n, &reference)) {
+            fprintf(stderr, "Out of memory\n");
+            break;
+        }
+        printf("%10llu %10zu", (unsigned long long)n, bn_bits(&reference));
+
+        // A fresh cache per row for the cold run; the warm run reuses it
+        FibCache cache;
+        fib_cache_init(&cache);
+
+        for (int m = 0; m < METHOD_COUNT; m++) {
+            if (n > method_limit[m]) {
+                printf(" %13s", "-");
+                continue;
+            }
+            clock_t start = clock();
+            int ok = 1;
+            uint64_t small = 0;
+            switch (m) {
+            case 0: small = (uint64_t)fib_recursive((int)n); break;
+            case 1: small = fib_iterative((int)n); break;
+            case 2: ok = fib_iterative_big(n, &result); break;
+            case 3:
+            case 4: ok = fib_memo(&cache, n, &result); break;
+            case 5: ok = fib_fast_doubling(n, &result); break;
+            }
+            clock_t end = clock();
+
+            // Every method must agree with the fast doubling result
+            int match;
+            if (m < 2) {
+                match = reference.len <= 1 && (reference.len ? reference.limbs[0] : 0) == small;
+            } else {
+                match = ok && bn_cmp(&result, &reference) == 0;
+            }
+            printf(" %12.3f%s", elapsed_ms(start, end), match ? " " : "!");
+        }
+        printf("\n");
+        fib_cache_free(&cache);
+    }
+    printf("('!' marks a result that did not match)\n");
+
+    bn_free(&reference);
+    bn_free(&result);
+}
@@ -0,0 +1,405 @@
+/*
+ * Exercise 4.6: Big Factorials
+ *
+ * Exercise 4.2 computes n! in a long, which overflows after 20!. Python's
+ * math.factorial(1000000) returns a 5.5-million-digit int in about a
+ * second; this exercise shows how, using BigNum (../common/bignum.c).
+ *
+ * Multiplying 1 * 2 * 3 * ... * n one step at a time is O(n^2): every
+ * step multiplies a huge number by a small one. Three ideas fix that:
+ *
+ *   1. Product tree (binary splitting): multiply the two halves of the
+ *      range separately and then multiply the results, so the big
+ *      multiplications are between numbers of similar size - where
+ *      Karatsuba shines.
+ *   2. Prime factorization: n! = 2^e2 * 3^e3 * 5^e5 * ..., with
+ *      e_p = n/p + n/p^2 + ... (Legendre's formula). Group the primes by
+ *      the bits of their exponents and build the answer by repeated
+ *      squaring, so each prime is multiplied in only log2(e_p) times.
+ *      The power of 2 becomes a single shift.
+ *   3. The subtrees are independent, so -t N evaluates them on N threads.
+ *
+ * Values that fit in 64 bits (up to 20!) come from a static table.
+ *
+ * Python equivalent:
+ *   import math
+ *   math.factorial(1000000)
+ *
+ * Compile: cc -Wall -O2 -pthread -o ex06_big_factorial ex06_big_factorial.c ../common/bignum.c -lm
+ * Run: ./ex06_big_factorial
+ *      ./ex06_big_factorial -t 4 1000000
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include "../common/bignum.h"
+
+#define MAX_THREADS 64
+// Product trees switch to a linear loop below this many factors
+#define LEAF_FACTORS 16
+
+// 0! .. 20!, the factorials that fit in uint64_t
+static const uint64_t small_factorials[21] = {
+    1ULL, 1ULL, 2ULL, 6ULL, 24ULL, 120ULL, 720ULL, 5040ULL, 40320ULL,
+    362880ULL, 3628800ULL, 39916800ULL, 479001600ULL, 6227020800ULL,
+    87178291200ULL, 1307674368000ULL, 20922789888000ULL,
+    355687428096000ULL, 6402373705728000ULL, 121645100408832000ULL,
+    2432902008176640000ULL,
+};
+
+// A growable list of 64-bit factors
+typedef struct {
+    uint64_t *items;
+    size_t count;
+    size_t capacity;
+} FactorList;
+
+// Function prototypes
+int factorial_naive(unsigned n, BigNum *out);
+int factorial_split(unsigned n, BigNum *out, int threads);
+int factorial_prime(unsigned n, BigNum *out, int threads);
+int factorial_big(unsigned n, BigNum *out, int threads);
+
+int parallel_product(const uint64_t *factors, size_t count, BigNum *out, int threads);
+void print_summary(unsigned n, const BigNum *value);
+void comparison_table(int threads);
+
+int main(int argc, char *argv[]) {
+    int threads = 1;
+    long n = -1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (argv[i][0] != '-') {
+            n = atol(argv[i]);
+        } else {
+            fprintf(stderr, "Usage: %s [-t threads] [n]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (threads < 1) threads = 1;
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+
+    BigNum f;
+    bn_init(&f);
+
+    if (n >= 0) {
+        if (n > 100000000) {
+            fprintf(stderr, "n is too large\n");
+            return 1;
+        }
+        if (!factorial_big((unsigned)n, &f, threads)) {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+        print_summary((unsigned)n, &f);
+        bn_free(&f);
+        return 0;
+    }
+
+    printf("Factorial Table (from the static table)\n");
+    printf("=======================================\n");
+    for (unsigned i = 0; i <= 20; i++) {
+        printf("%2u! = %llu\n", i, (unsigned long long)small_factorials[i]);
+    }
+
+    if (!factorial_big(100, &f, threads)) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    char *text = bn_to_string(&f);
+    printf("\n100! = %s\n", text ? text : "?");
+    free(text);
+    bn_free(&f);
+
+    comparison_table(threads);
+    return 0;
+}
+
+// --- Helpers ---
+
+static int list_push(FactorList *list, uint64_t value) {
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity ? list->capacity * 2 : 256;
+        uint64_t *grown = realloc(list->items, capacity * sizeof(uint64_t));
+        if (grown == NULL) {
+            return 0;
+        }
+        list->items = grown;
+        list->capacity = capacity;
+    }
+    list->items[list->count++] = value;
+    return 1;
+}
+
+// Multiply small factors together while the product fits in 64 bits, so
+// the product tree has fewer, fuller leaves. *acc is the running word.
+static int list_push_packed(FactorList *list, uint64_t *acc, uint64_t factor) {
+    uint64_t product;
+    if (!__builtin_mul_overflow(*acc, factor, &product)) {
+        *acc = product;
+        return 1;
+    }
+    int ok = list_push(list, *acc);
+    *acc = factor;
+    return ok;
+}
+
+// out = factors[0] * ... * factors[count-1], splitting the list in half
+static int product_tree(const uint64_t *factors, size_t count, BigNum *out) {
+    if (count <= LEAF_FACTORS) {
+        int ok = bn_set_u64(out, 1);
+        for (size_t i = 0; ok && i < count; i++) {
+            ok = bn_mul_u64(out, out, factors[i]);
+        }
+        return ok;
+    }
+    BigNum left, right;
+    bn_init(&left);
+    bn_init(&right);
+    size_t half = count / 2;
+    int ok = product_tree(factors, half, &left)
+             && product_tree(factors + half, count - half, &right)
+             && bn_mul(out, &left, &right);
+    bn_free(&left);
+    bn_free(&right);
+    return ok;
+}
+
+typedef struct {
+    const uint64_t *factors;
+    size_t count;
+    BigNum result;
+    int ok;
+} ProductJob;
+
+static void *product_job_main(void *arg) {
+    ProductJob *job = arg;
+    job->ok = product_tree(job->factors, job->count, &job->result);
+    return NULL;
+}
+
+// product_tree with the top of the tree split across threads: each
+// thread multiplies one contiguous slice, then the slice results are
+// multiplied pairwise (the largest products, on this thread).
+int parallel_product(const uint64_t *factors, size_t count, BigNum *out, int threads) {
+    if (threads <= 1 || count < (size_t)threads * LEAF_FACTORS * 4) {
+        return product_tree(factors, count, out);
+    }
+
+    ProductJob jobs[MAX_THREADS];
+    pthread_t tids[MAX_THREADS];
+    int started[MAX_THREADS];
+    for (int t = 0; t < threads; t++) {
+        size_t begin = count * (size_t)t / (size_t)threads;
+        size_t end = count * (size_t)(t + 1) / (size_t)threads;
+        jobs[t].factors = factors + begin;
+        jobs[t].count = end - begin;
+        jobs[t].ok = 0;
+        bn_init(&jobs[t].result);
+        started[t] = pthread_create(&tids[t], NULL, product_job_main, &jobs[t]) == 0;
+        if (!started[t]) {
+            product_job_main(&jobs[t]);  // Run it here instead
+        }
+    }
+    int ok = 1;
+    for (int t = 0; t < threads; t++) {
+        if (started[t]) {
+            pthread_join(tids[t], NULL);
+        }
+        ok = ok && jobs[t].ok;
+    }
+
+    // Combine neighbours until one result is left
+    for (int step = 1; ok && step < threads; step *= 2) {
+        for (int t = 0; ok && t + step < threads; t += 2 * step) {
+            ok = bn_mul(&jobs[t].result, &jobs[t].result, &jobs[t + step].result);
+        }
+    }
+    ok = ok && bn_copy(out, &jobs[0].result);
+    for (int t = 0; t < threads; t++) {
+        bn_free(&jobs[t].result);
+    }
+    return ok;
+}
+
+// --- Factorial methods ---
+
+// 1 * 2 * ... * n, one small multiply per step
+int factorial_naive(unsigned n, BigNum *out) {
+    int ok = bn_set_u64(out, 1);
+    for (unsigned i = 2; ok && i <= n; i++) {
+        ok = bn_mul_u64(out, out, i);
+    }
+    return ok;
+}
+
+// Product tree over the odd parts of 2..n. Every i = odd * 2^k, and the
+// powers of two add up to n - popcount(n), applied as one shift.
+int factorial_split(unsigned n, BigNum *out, int threads) {
+    FactorList list = {NULL, 0, 0};
+    uint64_t acc = 1;
+    int ok = 1;
+    for (unsigned i = 3; ok && i <= n; i += 2) {
+        ok = list_push_packed(&list, &acc, i);
+    }
+    // Odd parts of the even numbers: 2k contributes the odd part of k
+    for (unsigned k = 1; ok && 2 * (uint64_t)k <= n; k++) {
+        unsigned odd = k >> __builtin_ctz(k);
+        if (odd > 1) {
+            ok = list_push_packed(&list, &acc, odd);
+        }
+    }
+    ok = ok && list_push(&list, acc)
+         && parallel_product(list.items, list.count, out, threads)
+         && bn_shl(out, out, n - (size_t)__builtin_popcount(n));
+    free(list.items);
+    return ok;
+}
+
+// Prime factorization with exponents grouped by bit:
+//   n! = 2^e2 * prod over bits k (from high to low) of P_k^(2^k)
+// where P_k is the product of the odd primes whose exponent has bit k set.
+// Evaluated Horner-style: result = result^2 * P_k for each k.
+int factorial_prime(unsigned n, BigNum *out, int threads) {
+    // Sieve of Eratosthenes over odd numbers: is_composite[i] for 2i + 1
+    size_t half = n / 2 + 1;
+    unsigned char *is_composite = calloc(half, 1);
+    if (is_composite == NULL) {
+        return 0;
+    }
+    for (size_t i = 1; (2 * i + 1) * (2 * i + 1) <= n; i++) {
+        if (!is_composite[i]) {
+            size_t p = 2 * i + 1;
+            for (size_t j = p * p / 2; j < half; j += p) {
+                is_composite[j] = 1;
+            }
+        }
+    }
+
+    // The exponent of 3 is the largest, so it decides how many bits there are
+    int max_bit = 0;
+    unsigned e3 = 0;
+    for (uint64_t q = 3; q <= n; q *= 3) {
+        e3 += (unsigned)(n / q);
+    }
+    while ((e3 >> max_bit) > 1) {
+        max_bit++;
+    }
+
+    FactorList lists[32];
+    uint64_t accs[32];
+    for (int k = 0; k <= max_bit; k++) {
+        lists[k] = (FactorList){NULL, 0, 0};
+        accs[k] = 1;
+    }
+
+    int ok = 1;
+    for (size_t i = 1; ok && 2 * i + 1 <= n; i++) {
+        if (is_composite[i]) {
+            continue;
+        }
+        uint64_t p = 2 * i + 1;
+        unsigned e = 0;
+        for (uint64_t q = p; q <= n; q *= p) {
+            e += (unsigned)(n / q);
+        }
+        for (int k = 0; ok && e >> k; k++) {
+            if ((e >> k) & 1) {
+                ok = list_push_packed(&lists[k], &accs[k], p);
+            }
+        }
+    }
+    free(is_composite);
+
+    BigNum part;
+    bn_init(&part);
+    ok = ok && bn_set_u64(out, 1);
+    for (int k = max_bit; ok && k >= 0; k--) {
+        ok = list_push(&lists[k], accs[k])
+             && parallel_product(lists[k].items, lists[k].count, &part, threads)
+             && bn_mul(out, out, out)
+             && bn_mul(out, out, &part);
+    }
+    bn_free(&part);
+    for (int k = 0; k <= max_bit; k++) {
+        free(lists[k].items);
+    }
+
+    // Exponent of 2 is n - popcount(n)
+    return ok && bn_shl(out, out, n - (size_t)__builtin_popcount(n));
+}
+
+// n! by the fastest route for its size
+int factorial_big(unsigned n, BigNum *out, int threads) {
+    if (n <= 20) {
+        return bn_set_u64(out, small_factorials[n]);
+    }
+    return factorial_prime(n, out, threads);
+}
+
+// --- Output ---
+
+void print_summary(unsigned n, const BigNum *value) {
+    // Digit count from log10(n!) = lgamma(n + 1) / ln(10)
+    double digits = floor(lgamma((double)n + 1.0) / log(10.0)) + 1.0;
+    unsigned trailing_zeros = 0;
+    for (uint64_t q = 5; q <= n; q *= 5) {
+        trailing_zeros += (unsigned)(n / q);
+    }
+    printf("%u! has %.0f digits (%zu bits), %u trailing zeros\n",
+           n, digits, bn_bits(value), trailing_zeros);
+}
+
+// --- Comparison table ---
+
+static double seconds_now(void) {
+    // Wall-clock time, since threads run in parallel
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void comparison_table(int threads) {
+    const unsigned sizes[] = {1000, 10000, 100000, 1000000};
+    const int size_count = sizeof(sizes) / sizeof(sizes[0]);
+
+    printf("\n=== Comparison (milliseconds, %d thread%s) ===\n", threads, threads == 1 ? "" : "s");
+    printf("%10s %12s %12s %12s %14s\n", "n", "bits", "naive", "split", "prime");
+
+    BigNum reference, result;
+    bn_init(&reference);
+    bn_init(&result);
+    for (int s = 0; s < size_count; s++) {
+        unsigned n = sizes[s];
+        double t0 = seconds_now();
+        if (!factorial_prime(n, &reference, threads)) {
+            fprintf(stderr, "Out of memory\n");
+            break;
+        }
+        double prime_ms = (seconds_now() - t0) * 1e3;
+
+        printf("%10u %12zu", n, bn_bits(&reference));
+        if (n <= 100000) {
+            t0 = seconds_now();
+            int ok = factorial_naive(n, &result);
+            double ms = (seconds_now() - t0) * 1e3;
+            printf(" %11.1f%s", ms, ok && bn_cmp(&result, &reference) == 0 ? " " : "!");
+        } else {
+            printf(" %12s", "-");
+        }
+        t0 = seconds_now();
+        int ok = factorial_split(n, &result, threads);
+        double ms = (seconds_now() - t0) * 1e3;
+        printf(" %11.1f%s", ms, ok && bn_cmp(&result, &reference) == 0 ? " " : "!");
+        printf(" %13.1f\n", prime_ms);
+    }
+    printf("('!' marks a result that did not match the prime method)\n");
+    bn_free(&reference);
+    bn_free(&result);
+}
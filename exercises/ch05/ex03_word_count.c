@@ -7,15 +7,18 @@
  *   text = "Hello World from C programming"
  *   word_count = len(text.split())
  *
- * Compile: cc -Wall -o ex03_word_count ex03_word_count.c
+ * The word-splitting logic lives in ../common/wordsplit.c, which
+ * Exercise 9.2 (wc) shares.
+ *
+ * Compile: cc -Wall -o ex03_word_count ex03_word_count.c ../common/wordsplit.c
  * Run: ./ex03_word_count
  */
 
 #include <stdio.h>
-#include <ctype.h>  // For isspace()
+#include <string.h>
+#include "../common/wordsplit.h"
 
-// TODO: Implement count_words
-// Hint: Count transitions from space to non-space
+// Count transitions from space to non-space
 int count_words(const char *s);
 
 int main(void) {
@@ -38,8 +41,6 @@ int main(void) {
 }
 
 int count_words(const char *s) {
-    // TODO: Implement word counting
-    // Hint: Track whether you're currently "in a word"
-    // Hint: Use isspace(c) to check if c is whitespace
-    return 0;
+    int in_word = 0;
+    return (int)ws_count_words(s, strlen(s), &in_word);
 }
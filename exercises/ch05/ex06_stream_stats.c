@@ -0,0 +1,458 @@
+/*
+ * Exercise 5.6: Streaming Array Statistics
+ *
+ * Exercise 5.1 computes statistics over an array that lives in memory.
+ * This version reads numbers from a file (or stdin) in large blocks and
+ * keeps only running totals, so the input can be far larger than RAM.
+ *
+ * Python version:
+ *   count, mean, m2 = 0, 0.0, 0.0
+ *   with open("metrics.txt") as f:
+ *       for line in f:
+ *           x = float(line)
+ *           count += 1
+ *           delta = x - mean
+ *           mean += delta / count
+ *           m2 += delta * (x - mean)
+ *   print(f"Mean: {mean}, Variance: {m2 / (count - 1)}")
+ *
+ * Mean and variance use Welford's algorithm (numerically stable, one pass).
+ * Approximate quantiles (p50, p99, ...) come from a KLL sketch: a stack of
+ * small sorted buffers where each level keeps every other item of the level
+ * below, so each survivor stands in for 2^level original values.
+ *
+ * Input formats (-f):
+ *   text  whitespace-separated numbers (default)
+ *   i32   raw native-endian 32-bit integers
+ *   i64   raw native-endian 64-bit integers
+ *   f64   raw native-endian doubles
+ *
+ * Compile: cc -Wall -O2 -o ex06_stream_stats ex06_stream_stats.c -lm
+ * Run: ./ex06_stream_stats metrics.txt
+ *      ./ex06_stream_stats -f f64 < metrics.bin
+ *      seq 1 1000000 | ./ex06_stream_stats
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define BLOCK_SIZE (1 << 20)   // Bytes read per fread() call
+#define KLL_K 200              // Sketch accuracy (~1.65/k rank error)
+#define KLL_MAX_LEVELS 64
+
+typedef enum {
+    FORMAT_TEXT,
+    FORMAT_I32,
+    FORMAT_I64,
+    FORMAT_F64
+} Format;
+
+typedef struct {
+    double *items;
+    int count;
+} KllLevel;
+
+typedef struct {
+    KllLevel levels[KLL_MAX_LEVELS];
+    int capacity[KLL_MAX_LEVELS];
+    int num_levels;
+    unsigned int rng;
+    int full;           // A compress ran out of memory; no more adds
+} KllSketch;
+
+typedef struct {
+    long long count;
+    double sum;
+    double sum_err;   // Kahan compensation term for sum
+    double mean;
+    double m2;        // Sum of squared deviations from the mean
+    double min;
+    double max;
+    KllSketch sketch;
+} StreamStats;
+
+// Function prototypes
+void stats_init(StreamStats *st);
+void stats_add(StreamStats *st, double x);
+double stats_variance(const StreamStats *st);
+void stats_free(StreamStats *st);
+
+int kll_init(KllSketch *s);
+int kll_add(KllSketch *s, double x);
+double kll_quantile(const KllSketch *s, double q);
+void kll_free(KllSketch *s);
+
+int stream_text(FILE *f, StreamStats *st);
+int stream_binary(FILE *f, Format fmt, StreamStats *st);
+
+int main(int argc, char *argv[]) {
+    Format fmt = FORMAT_TEXT;
+    const char *filename = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            const char *name = argv[++i];
+            if (strcmp(name, "text") == 0) fmt = FORMAT_TEXT;
+            else if (strcmp(name, "i32") == 0) fmt = FORMAT_I32;
+            else if (strcmp(name, "i64") == 0) fmt = FORMAT_I64;
+            else if (strcmp(name, "f64") == 0) fmt = FORMAT_F64;
+            else {
+                fprintf(stderr, "Unknown format: %s\n", name);
+                return 1;
+            }
+        } else if (filename == NULL) {
+            filename = argv[i];
+        } else {
+            fprintf(stderr, "Usage: %s [-f text|i32|i64|f64] [file]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    FILE *f = stdin;
+    if (filename != NULL) {
+        f = fopen(filename, fmt == FORMAT_TEXT ? "r" : "rb");
+        if (f == NULL) {
+            perror(filename);
+            return 1;
+        }
+    }
+
+    StreamStats st;
+    stats_init(&st);
+    if (st.sketch.levels[0].items == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    int ok = (fmt == FORMAT_TEXT) ? stream_text(f, &st)
+                                  : stream_binary(f, fmt, &st);
+    if (f != stdin) {
+        fclose(f);
+    }
+    if (!ok) {
+        stats_free(&st);
+        return 1;
+    }
+    if (st.sketch.full) {
+        fprintf(stderr, "Warning: out of memory, quantiles only cover the first values\n");
+    }
+
+    if (st.count == 0) {
+        printf("No values read.\n");
+        stats_free(&st);
+        return 0;
+    }
+
+    printf("Count:    %lld\n", st.count);
+    printf("Sum:      %.6g\n", st.sum);
+    printf("Mean:     %.6g\n", st.mean);
+    printf("Variance: %.6g\n", stats_variance(&st));
+    printf("Std dev:  %.6g\n", sqrt(stats_variance(&st)));
+    printf("Min:      %.6g\n", st.min);
+    printf("Max:      %.6g\n", st.max);
+    printf("p50:      %.6g (approx)\n", kll_quantile(&st.sketch, 0.50));
+    printf("p90:      %.6g (approx)\n", kll_quantile(&st.sketch, 0.90));
+    printf("p99:      %.6g (approx)\n", kll_quantile(&st.sketch, 0.99));
+
+    stats_free(&st);
+    return 0;
+}
+
+void stats_init(StreamStats *st) {
+    st->count = 0;
+    st->sum = 0.0;
+    st->sum_err = 0.0;
+    st->mean = 0.0;
+    st->m2 = 0.0;
+    st->min = INFINITY;
+    st->max = -INFINITY;
+    kll_init(&st->sketch);
+}
+
+void stats_add(StreamStats *st, double x) {
+    st->count++;
+
+    // Kahan summation keeps the total accurate over billions of values
+    double y = x - st->sum_err;
+    double t = st->sum + y;
+    st->sum_err = (t - st->sum) - y;
+    st->sum = t;
+
+    // Welford's update
+    double delta = x - st->mean;
+    st->mean += delta / (double)st->count;
+    st->m2 += delta * (x - st->mean);
+
+    if (x < st->min) st->min = x;
+    if (x > st->max) st->max = x;
+
+    kll_add(&st->sketch, x);
+}
+
+double stats_variance(const StreamStats *st) {
+    // Sample variance, like Python's statistics.variance()
+    if (st->count < 2) {
+        return 0.0;
+    }
+    return st->m2 / (double)(st->count - 1);
+}
+
+void stats_free(StreamStats *st) {
+    kll_free(&st->sketch);
+}
+
+// --- KLL sketch ---
+
+// Level h holds at most ~k * (2/3)^depth items, where depth counts
+// down from the top level. Lower levels shrink, so total memory stays
+// around 3k items no matter how many values pass through.
+static int kll_grow(KllSketch *s) {
+    if (s->num_levels == KLL_MAX_LEVELS) {
+        return 0;
+    }
+    // A level can briefly hold its capacity (at most k+1) plus half of
+    // the level below, so every buffer gets 2k+4 slots up front. That
+    // way capacities can change as levels are added without reallocating.
+    double *items = malloc((2 * KLL_K + 4) * sizeof(double));
+    if (items == NULL) {
+        return 0;
+    }
+    s->levels[s->num_levels].items = items;
+    s->levels[s->num_levels].count = 0;
+    s->num_levels++;
+
+    for (int h = 0; h < s->num_levels; h++) {
+        int depth = s->num_levels - h - 1;
+        s->capacity[h] = (int)ceil(KLL_K * pow(2.0 / 3.0, depth)) + 1;
+    }
+    return 1;
+}
+
+int kll_init(KllSketch *s) {
+    memset(s, 0, sizeof(*s));
+    s->rng = 2463534242u;
+    return kll_grow(s);
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static unsigned int kll_random_bit(KllSketch *s) {
+    // xorshift32 - cheap and good enough for a coin flip
+    s->rng ^= s->rng << 13;
+    s->rng ^= s->rng >> 17;
+    s->rng ^= s->rng << 5;
+    return s->rng & 1;
+}
+
+// Returns 0 if a level needed to be added but could not be
+static int kll_compress(KllSketch *s) {
+    for (int h = 0; h < s->num_levels; h++) {
+        KllLevel *level = &s->levels[h];
+        if (level->count < s->capacity[h]) {
+            continue;
+        }
+        if (h + 1 == s->num_levels && !kll_grow(s)) {
+            return 0;
+        }
+        // kll_grow() may have changed capacities, but not the pointers
+        KllLevel *next = &s->levels[h + 1];
+
+        qsort(level->items, level->count, sizeof(double), compare_doubles);
+
+        // Promote every other item (random phase) to the next level.
+        // With an odd count the smallest item stays behind.
+        int keep = level->count & 1;
+        int start = keep + (int)kll_random_bit(s);
+        for (int i = start; i < level->count; i += 2) {
+            next->items[next->count++] = level->items[i];
+        }
+        level->count = keep;
+    }
+    return 1;
+}
+
+// Returns 0 once the sketch has run out of memory. A full level can't
+// be compressed any more, so later values are dropped instead of
+// written past its buffer.
+int kll_add(KllSketch *s, double x) {
+    if (s->full) {
+        return 0;
+    }
+    KllLevel *level0 = &s->levels[0];
+    level0->items[level0->count++] = x;
+    if (level0->count >= s->capacity[0] && !kll_compress(s)) {
+        s->full = 1;
+        return 0;
+    }
+    return 1;
+}
+
+typedef struct {
+    double value;
+    double weight;
+} WeightedItem;
+
+static int compare_weighted(const void *a, const void *b) {
+    double x = ((const WeightedItem *)a)->value;
+    double y = ((const WeightedItem *)b)->value;
+    return (x > y) - (x < y);
+}
+
+double kll_quantile(const KllSketch *s, double q) {
+    int total = 0;
+    for (int h = 0; h < s->num_levels; h++) {
+        total += s->levels[h].count;
+    }
+    if (total == 0) {
+        return NAN;
+    }
+
+    WeightedItem *items = malloc(total * sizeof(WeightedItem));
+    if (items == NULL) {
+        return NAN;
+    }
+
+    int n = 0;
+    double total_weight = 0.0;
+    for (int h = 0; h < s->num_levels; h++) {
+        double weight = ldexp(1.0, h);
+        for (int i = 0; i < s->levels[h].count; i++) {
+            items[n].value = s->levels[h].items[i];
+            items[n].weight = weight;
+            total_weight += weight;
+            n++;
+        }
+    }
+    qsort(items, n, sizeof(WeightedItem), compare_weighted);
+
+    double target = q * total_weight;
+    double cumulative = 0.0;
+    double result = items[n - 1].value;
+    for (int i = 0; i < n; i++) {
+        cumulative += items[i].weight;
+        if (cumulative >= target) {
+            result = items[i].value;
+            break;
+        }
+    }
+
+    free(items);
+    return result;
+}
+
+void kll_free(KllSketch *s) {
+    for (int h = 0; h < s->num_levels; h++) {
+        free(s->levels[h].items);
+        s->levels[h].items = NULL;
+    }
+    s->num_levels = 0;
+}
+
+// --- Input readers ---
+
+int stream_text(FILE *f, StreamStats *st) {
+    // One extra byte for the '\0' that strtod() needs
+    char *buf = malloc(BLOCK_SIZE + 1);
+    if (buf == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 0;
+    }
+
+    size_t carry = 0;   // Bytes of an unfinished number kept from last block
+    while (1) {
+        size_t n = fread(buf + carry, 1, BLOCK_SIZE - carry, f);
+        size_t len = carry + n;
+        int at_eof = (n == 0);
+        if (len == 0) {
+            break;
+        }
+
+        // Only parse up to the last whitespace; the tail may be a number
+        // that continues in the next block.
+        size_t end = len;
+        if (!at_eof) {
+            while (end > 0 && !strchr(" \t\r\n", buf[end - 1])) {
+                end--;
+            }
+            if (end == 0) {
+                if (len == BLOCK_SIZE) {
+                    fprintf(stderr, "Token longer than %d bytes\n", BLOCK_SIZE);
+                    free(buf);
+                    return 0;
+                }
+                carry = len;
+                continue;
+            }
+        }
+
+        char saved = buf[end];
+        buf[end] = '\0';
+        char *p = buf;
+        while (1) {
+            char *next;
+            double x = strtod(p, &next);
+            if (next == p) {
+                // Skip whitespace or a junk token
+                while (*p != '\0' && strchr(" \t\r\n", *p)) p++;
+                if (*p == '\0') break;
+                while (*p != '\0' && !strchr(" \t\r\n", *p)) p++;
+                continue;
+            }
+            stats_add(st, x);
+            p = next;
+        }
+        buf[end] = saved;
+
+        carry = len - end;
+        memmove(buf, buf + end, carry);
+        if (at_eof) {
+            break;
+        }
+    }
+
+    int ok = !ferror(f);
+    if (!ok) {
+        perror("read");
+    }
+    free(buf);
+    return ok;
+}
+
+int stream_binary(FILE *f, Format fmt, StreamStats *st) {
+    size_t width = (fmt == FORMAT_I32) ? 4 : 8;
+    size_t per_block = BLOCK_SIZE / width;
+
+    // Allocate as long long so the buffer is aligned for every format
+    long long *block = malloc(per_block * 8);
+    if (block == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 0;
+    }
+
+    size_t n;
+    while ((n = fread(block, width, per_block, f)) > 0) {
+        if (fmt == FORMAT_I32) {
+            const int *v = (const int *)block;
+            for (size_t i = 0; i < n; i++) stats_add(st, (double)v[i]);
+        } else if (fmt == FORMAT_I64) {
+            const long long *v = block;
+            for (size_t i = 0; i < n; i++) stats_add(st, (double)v[i]);
+        } else {
+            const double *v = (const double *)block;
+            for (size_t i = 0; i < n; i++) stats_add(st, v[i]);
+        }
+    }
+
+    int ok = !ferror(f);
+    if (!ok) {
+        perror("read");
+    }
+    free(block);
+    return ok;
+}
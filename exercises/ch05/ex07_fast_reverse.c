@@ -0,0 +1,222 @@
+/*
+ * Exercise 5.7: Fast In-Place String Reversal
+ *
+ * Exercise 5.2 swaps one byte at a time from both ends. That is fine for
+ * "hello", but on multi-megabyte buffers the loop is limited by how many
+ * bytes it moves per instruction. Here we swap whole 16- or 32-byte blocks
+ * and reverse the bytes inside each block with a single shuffle
+ * instruction, falling back to the byte loop for the middle leftover.
+ *
+ * Python equivalent:
+ *   s = s[::-1]                        # bytes or code points
+ *   b = s.encode()[::-1]               # raw bytes (breaks UTF-8!)
+ *
+ * Reversing raw bytes scrambles multibyte UTF-8 characters ("é" is two
+ * bytes, C3 A9). reverse_utf8() reverses code points instead, like
+ * Python's str[::-1]. Like Python, it does not know about combining
+ * marks: "e" followed by U+0301 (a combining accent) comes out with the
+ * accent first.
+ *
+ * The SIMD kernels are picked at compile time. Build with -march=native
+ * (or -mssse3 / -mavx2) to enable them; without those flags you get the
+ * portable scalar version.
+ *
+ * Compile: cc -Wall -O2 -march=native -o ex07_fast_reverse ex07_fast_reverse.c
+ * Run: ./ex07_fast_reverse
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__SSSE3__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#define BENCH_SIZE (64 * 1024 * 1024)
+#define BENCH_REPEAT 10   // Keep even: the buffer must end up unchanged
+
+// Function prototypes
+void reverse_bytes_scalar(char *s, size_t len);
+void reverse_bytes_sse(char *s, size_t len);
+void reverse_bytes_avx2(char *s, size_t len);
+void reverse_bytes(char *s, size_t len);
+void reverse_utf8(char *s, size_t len);
+void reverse_string(char *s);
+
+typedef void (*ReverseFn)(char *s, size_t len);
+void benchmark(const char *name, ReverseFn fn, char *buf, const char *expected);
+
+int main(void) {
+    char s1[] = "hello";
+    char s2[] = "C programming";
+    char s3[] = "the quick brown fox jumps over the lazy dog, twice over";
+
+    printf("=== Byte Mode ===\n");
+    char *tests[] = {s1, s2, s3};
+    for (int i = 0; i < 3; i++) {
+        printf("Original: \"%s\"\n", tests[i]);
+        reverse_string(tests[i]);
+        printf("Reversed: \"%s\"\n\n", tests[i]);
+    }
+
+    printf("=== UTF-8 Mode ===\n");
+    char u1[] = "h\xc3\xa9llo w\xc3\xb6rld";           // héllo wörld
+    char u2[] = "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e"; // 日本語
+    char u3[] = "snake \xf0\x9f\x90\x8d!";             // snake 🐍!
+    char *utf8_tests[] = {u1, u2, u3};
+    for (int i = 0; i < 3; i++) {
+        printf("Original: \"%s\"\n", utf8_tests[i]);
+        reverse_utf8(utf8_tests[i], strlen(utf8_tests[i]));
+        printf("Reversed: \"%s\"\n\n", utf8_tests[i]);
+    }
+
+    printf("=== Benchmark (%d MiB, %d runs) ===\n",
+           BENCH_SIZE / (1024 * 1024), BENCH_REPEAT);
+
+    char *buf = malloc(BENCH_SIZE);
+    char *expected = malloc(BENCH_SIZE);
+    if (buf == NULL || expected == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        free(buf);
+        free(expected);
+        return 1;
+    }
+
+    // Odd length so every kernel has a middle remainder to deal with
+    size_t len = BENCH_SIZE - 7;
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = 'a' + (char)(i % 26);
+    }
+    memcpy(expected, buf, len);
+    reverse_bytes_scalar(expected, len);
+
+    benchmark("scalar", reverse_bytes_scalar, buf, expected);
+    benchmark("sse (16B)", reverse_bytes_sse, buf, expected);
+    benchmark("avx2 (32B)", reverse_bytes_avx2, buf, expected);
+    benchmark("utf8", reverse_utf8, buf, expected);
+
+    free(buf);
+    free(expected);
+    return 0;
+}
+
+void reverse_string(char *s) {
+    reverse_bytes(s, strlen(s));
+}
+
+void reverse_bytes_scalar(char *s, size_t len) {
+    if (len < 2) {
+        return;
+    }
+    char *left = s;
+    char *right = s + len - 1;
+    while (left < right) {
+        char tmp = *left;
+        *left++ = *right;
+        *right-- = tmp;
+    }
+}
+
+void reverse_bytes_sse(char *s, size_t len) {
+#ifdef __SSSE3__
+    // pshufb mask: output byte i takes input byte 15 - i
+    const __m128i mask = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8,
+                                       7, 6, 5, 4, 3, 2, 1, 0);
+    char *left = s;
+    char *right = s + len;   // One past the last byte
+
+    // Swap a block from each end while they don't overlap
+    while (right - left >= 32) {
+        right -= 16;
+        __m128i a = _mm_loadu_si128((const __m128i *)left);
+        __m128i b = _mm_loadu_si128((const __m128i *)right);
+        _mm_storeu_si128((__m128i *)left, _mm_shuffle_epi8(b, mask));
+        _mm_storeu_si128((__m128i *)right, _mm_shuffle_epi8(a, mask));
+        left += 16;
+    }
+    reverse_bytes_scalar(left, right - left);
+#else
+    reverse_bytes_scalar(s, len);
+#endif
+}
+
+void reverse_bytes_avx2(char *s, size_t len) {
+#ifdef __AVX2__
+    // vpshufb only shuffles within each 16-byte lane, so reverse both
+    // lanes first and then swap the two lanes with vpermq.
+    const __m256i mask = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8,
+                                          7, 6, 5, 4, 3, 2, 1, 0,
+                                          15, 14, 13, 12, 11, 10, 9, 8,
+                                          7, 6, 5, 4, 3, 2, 1, 0);
+    char *left = s;
+    char *right = s + len;
+
+    while (right - left >= 64) {
+        right -= 32;
+        __m256i a = _mm256_loadu_si256((const __m256i *)left);
+        __m256i b = _mm256_loadu_si256((const __m256i *)right);
+        a = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(a, mask), 0x4E);
+        b = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(b, mask), 0x4E);
+        _mm256_storeu_si256((__m256i *)left, b);
+        _mm256_storeu_si256((__m256i *)right, a);
+        left += 32;
+    }
+    // At most 63 bytes left: one SSE step and then scalar
+    reverse_bytes_sse(left, right - left);
+#else
+    reverse_bytes_sse(s, len);
+#endif
+}
+
+void reverse_bytes(char *s, size_t len) {
+    // Widest kernel available; each one falls back to the next
+    reverse_bytes_avx2(s, len);
+}
+
+void reverse_utf8(char *s, size_t len) {
+    // Reverse all bytes (fast path), then put each multibyte character
+    // back in order. After the byte reverse, a character looks like
+    // its continuation bytes (10xxxxxx) followed by its lead byte.
+    reverse_bytes(s, len);
+
+    size_t i = 0;
+    while (i < len) {
+        unsigned char c = (unsigned char)s[i];
+        if ((c & 0xC0) != 0x80) {
+            i++;   // ASCII or a lead byte on its own
+            continue;
+        }
+        size_t start = i;
+        while (i < len && ((unsigned char)s[i] & 0xC0) == 0x80) {
+            i++;
+        }
+        if (i == len) {
+            break;   // Stray continuation bytes with no lead: leave as is
+        }
+        // s[start..i] is the character backwards, lead byte at s[i]
+        reverse_bytes_scalar(s + start, i - start + 1);
+        i++;
+    }
+}
+
+void benchmark(const char *name, ReverseFn fn, char *buf, const char *expected) {
+    size_t len = BENCH_SIZE - 7;
+
+    clock_t start = clock();
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+        fn(buf, len);
+    }
+    clock_t end = clock();
+
+    // An even number of runs leaves the buffer as it started
+    fn(buf, len);
+    int ok = memcmp(buf, expected, len) == 0;
+    fn(buf, len);
+
+    double seconds = ((double)(end - start)) / CLOCKS_PER_SEC;
+    double gbytes = (double)len * BENCH_REPEAT / 1e9;
+    printf("%-12s %8.4f s  %6.2f GB/s  %s\n", name, seconds,
+           seconds > 0 ? gbytes / seconds : 0.0, ok ? "ok" : "MISMATCH");
+}
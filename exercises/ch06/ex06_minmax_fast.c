@@ -0,0 +1,292 @@
+/*
+ * Exercise 6.6: Faster Min and Max
+ *
+ * Exercise 6.3 returns min and max through pointers. The obvious loop
+ * compares every element against both, which is 2n comparisons. Three
+ * faster ways to fill the same two output parameters:
+ *
+ *   1. Pairwise: compare the two elements of a pair with each other
+ *      first, then only the smaller against min and the larger against
+ *      max. That is 3 comparisons per 2 elements (3n/2 total).
+ *   2. SIMD: keep 4 or 8 running minimums/maximums in one register and
+ *      update them all with a single packed min/max instruction, then
+ *      reduce the lanes to one value at the end.
+ *   3. Arg min/max: also report WHERE the min and max are (first
+ *      occurrence), like Python's arr.index(min(arr)).
+ *
+ * Python version:
+ *   lo, hi = min(arr), max(arr)
+ *   lo_i, hi_i = arr.index(lo), arr.index(hi)
+ *
+ * The benchmark runs each version on sorted, reversed and random input.
+ * Sorted input is the naive loop's best case: the branches are perfectly
+ * predictable. Random input is where branchy code pays: the pairwise
+ * version does fewer comparisons, but its "which of the pair is smaller"
+ * branch is a coin flip on random data and can end up slower than naive.
+ *
+ * Build with -march=native (or -msse4.1 / -mavx2) for the SIMD paths;
+ * without them the "simd" functions use a plain loop the compiler may
+ * still vectorize.
+ *
+ * Compile: cc -Wall -O2 -march=native -o ex06_minmax_fast ex06_minmax_fast.c
+ * Run: ./ex06_minmax_fast
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(__SSE4_1__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#define BENCH_SIZE (16 * 1024 * 1024)
+#define BENCH_REPEAT 10
+
+// Function prototypes
+void find_minmax_naive(int arr[], int size, int *min, int *max);
+void find_minmax_pairwise(int arr[], int size, int *min, int *max);
+void find_minmax_simd(int arr[], int size, int *min, int *max);
+void find_argminmax(int arr[], int size, int *min_index, int *max_index);
+void find_argminmax_simd(int arr[], int size, int *min_index, int *max_index);
+
+typedef void (*MinMaxFn)(int arr[], int size, int *a, int *b);
+double time_minmax(MinMaxFn fn, int arr[], int size, int *a, int *b);
+
+int main(void) {
+    int numbers[] = {23, 45, 12, 67, 34, 89, 21, 5, 78};
+    int size = sizeof(numbers) / sizeof(numbers[0]);
+    int minimum, maximum, min_i, max_i;
+
+    printf("Array: ");
+    for (int i = 0; i < size; i++) {
+        printf("%d ", numbers[i]);
+    }
+    printf("\n");
+
+    find_minmax_pairwise(numbers, size, &minimum, &maximum);
+    printf("Pairwise: min = %d, max = %d\n", minimum, maximum);
+
+    find_minmax_simd(numbers, size, &minimum, &maximum);
+    printf("SIMD:     min = %d, max = %d\n", minimum, maximum);
+
+    find_argminmax_simd(numbers, size, &min_i, &max_i);
+    printf("Argmin:   numbers[%d] = %d\n", min_i, numbers[min_i]);
+    printf("Argmax:   numbers[%d] = %d\n", max_i, numbers[max_i]);
+
+    // Benchmark
+    int *data = malloc(BENCH_SIZE * sizeof(int));
+    if (data == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    const char *orders[] = {"sorted", "reversed", "random"};
+    MinMaxFn fns[] = {find_minmax_naive, find_minmax_pairwise, find_minmax_simd,
+                      find_argminmax, find_argminmax_simd};
+    const char *names[] = {"naive", "pairwise", "simd", "argminmax", "argminmax simd"};
+    int num_fns = sizeof(fns) / sizeof(fns[0]);
+
+    printf("\n=== Benchmark: %d ints, best of %d runs (ms) ===\n",
+           BENCH_SIZE, BENCH_REPEAT);
+    printf("%-16s %10s %10s %10s\n", "", orders[0], orders[1], orders[2]);
+
+    double times[5][3];
+    int all_ok = 1;
+    srand(42);
+    for (int o = 0; o < 3; o++) {
+        for (int i = 0; i < BENCH_SIZE; i++) {
+            if (o == 0) data[i] = i - BENCH_SIZE / 2;
+            else if (o == 1) data[i] = BENCH_SIZE / 2 - i;
+            else data[i] = rand() - RAND_MAX / 2;
+        }
+
+        int want_min, want_max;
+        find_minmax_naive(data, BENCH_SIZE, &want_min, &want_max);
+
+        for (int f = 0; f < num_fns; f++) {
+            int a, b;
+            times[f][o] = time_minmax(fns[f], data, BENCH_SIZE, &a, &b);
+            if (f >= 3) {
+                // Arg versions return indices
+                a = data[a];
+                b = data[b];
+            }
+            if (a != want_min || b != want_max) {
+                printf("MISMATCH: %s on %s input\n", names[f], orders[o]);
+                all_ok = 0;
+            }
+        }
+    }
+
+    for (int f = 0; f < num_fns; f++) {
+        printf("%-16s %10.2f %10.2f %10.2f\n", names[f],
+               times[f][0], times[f][1], times[f][2]);
+    }
+    printf("%s\n", all_ok ? "All results match." : "Results differ!");
+
+    free(data);
+    return all_ok ? 0 : 1;
+}
+
+// The loop from Exercise 6.3: two comparisons per element
+void find_minmax_naive(int arr[], int size, int *min, int *max) {
+    *min = arr[0];
+    *max = arr[0];
+    for (int i = 1; i < size; i++) {
+        if (arr[i] < *min) *min = arr[i];
+        if (arr[i] > *max) *max = arr[i];
+    }
+}
+
+void find_minmax_pairwise(int arr[], int size, int *min, int *max) {
+    int lo, hi, i;
+
+    // Seed with the first element (odd size) or first pair (even size)
+    // so the rest of the array splits into whole pairs.
+    if (size % 2 == 1) {
+        lo = hi = arr[0];
+        i = 1;
+    } else {
+        if (arr[0] < arr[1]) {
+            lo = arr[0];
+            hi = arr[1];
+        } else {
+            lo = arr[1];
+            hi = arr[0];
+        }
+        i = 2;
+    }
+
+    for (; i + 1 < size; i += 2) {
+        int a = arr[i];
+        int b = arr[i + 1];
+        if (a < b) {
+            if (a < lo) lo = a;
+            if (b > hi) hi = b;
+        } else {
+            if (b < lo) lo = b;
+            if (a > hi) hi = a;
+        }
+    }
+
+    *min = lo;
+    *max = hi;
+}
+
+void find_minmax_simd(int arr[], int size, int *min, int *max) {
+    int i = 0;
+    int lo = arr[0];
+    int hi = arr[0];
+
+#if defined(__AVX2__)
+    if (size >= 8) {
+        __m256i vmin = _mm256_loadu_si256((const __m256i *)arr);
+        __m256i vmax = vmin;
+        for (i = 8; i + 8 <= size; i += 8) {
+            __m256i v = _mm256_loadu_si256((const __m256i *)(arr + i));
+            vmin = _mm256_min_epi32(vmin, v);
+            vmax = _mm256_max_epi32(vmax, v);
+        }
+        // Horizontal reduce: fold 8 lanes -> 4 -> 2 -> 1
+        __m128i mn = _mm_min_epi32(_mm256_castsi256_si128(vmin),
+                                   _mm256_extracti128_si256(vmin, 1));
+        __m128i mx = _mm_max_epi32(_mm256_castsi256_si128(vmax),
+                                   _mm256_extracti128_si256(vmax, 1));
+        mn = _mm_min_epi32(mn, _mm_shuffle_epi32(mn, _MM_SHUFFLE(1, 0, 3, 2)));
+        mx = _mm_max_epi32(mx, _mm_shuffle_epi32(mx, _MM_SHUFFLE(1, 0, 3, 2)));
+        mn = _mm_min_epi32(mn, _mm_shuffle_epi32(mn, _MM_SHUFFLE(2, 3, 0, 1)));
+        mx = _mm_max_epi32(mx, _mm_shuffle_epi32(mx, _MM_SHUFFLE(2, 3, 0, 1)));
+        lo = _mm_cvtsi128_si32(mn);
+        hi = _mm_cvtsi128_si32(mx);
+    }
+#elif defined(__SSE4_1__)
+    if (size >= 4) {
+        __m128i vmin = _mm_loadu_si128((const __m128i *)arr);
+        __m128i vmax = vmin;
+        for (i = 4; i + 4 <= size; i += 4) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(arr + i));
+            vmin = _mm_min_epi32(vmin, v);
+            vmax = _mm_max_epi32(vmax, v);
+        }
+        vmin = _mm_min_epi32(vmin, _mm_shuffle_epi32(vmin, _MM_SHUFFLE(1, 0, 3, 2)));
+        vmax = _mm_max_epi32(vmax, _mm_shuffle_epi32(vmax, _MM_SHUFFLE(1, 0, 3, 2)));
+        vmin = _mm_min_epi32(vmin, _mm_shuffle_epi32(vmin, _MM_SHUFFLE(2, 3, 0, 1)));
+        vmax = _mm_max_epi32(vmax, _mm_shuffle_epi32(vmax, _MM_SHUFFLE(2, 3, 0, 1)));
+        lo = _mm_cvtsi128_si32(vmin);
+        hi = _mm_cvtsi128_si32(vmax);
+    }
+#endif
+
+    // Remainder (or the whole array without SIMD). Written with ?: so
+    // the compiler can turn it into branch-free min/max instructions.
+    for (; i < size; i++) {
+        lo = arr[i] < lo ? arr[i] : lo;
+        hi = arr[i] > hi ? arr[i] : hi;
+    }
+
+    *min = lo;
+    *max = hi;
+}
+
+void find_argminmax(int arr[], int size, int *min_index, int *max_index) {
+    int lo = 0;
+    int hi = 0;
+    for (int i = 1; i < size; i++) {
+        if (arr[i] < arr[lo]) lo = i;
+        if (arr[i] > arr[hi]) hi = i;
+    }
+    *min_index = lo;
+    *max_index = hi;
+}
+
+// Index of the first element equal to value (which must be present)
+static int find_first(int arr[], int size, int value) {
+    int i = 0;
+#if defined(__AVX2__)
+    __m256i target = _mm256_set1_epi32(value);
+    for (; i + 8 <= size; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(arr + i));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, target)));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+#elif defined(__SSE4_1__)
+    __m128i target = _mm_set1_epi32(value);
+    for (; i + 4 <= size; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(arr + i));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, target)));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+#endif
+    while (i < size && arr[i] != value) {
+        i++;
+    }
+    return i;
+}
+
+void find_argminmax_simd(int arr[], int size, int *min_index, int *max_index) {
+    // Two fast passes beat one slow one: find the values with packed
+    // min/max, then locate their first occurrence with packed compares.
+    int lo, hi;
+    find_minmax_simd(arr, size, &lo, &hi);
+    *min_index = find_first(arr, size, lo);
+    *max_index = find_first(arr, size, hi);
+}
+
+double time_minmax(MinMaxFn fn, int arr[], int size, int *a, int *b) {
+    double best = 0.0;
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+        clock_t start = clock();
+        fn(arr, size, a, b);
+        clock_t end = clock();
+        double ms = 1000.0 * (double)(end - start) / CLOCKS_PER_SEC;
+        if (r == 0 || ms < best) {
+            best = ms;
+        }
+    }
+    return best;
+}
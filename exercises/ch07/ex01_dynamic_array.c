@@ -11,12 +11,13 @@
  *
  * In C, we must manage memory manually.
  *
- * Compile: cc -Wall -o ex01_dynamic_array ex01_dynamic_array.c
+ * Compile: cc -Wall -o ex01_dynamic_array ex01_dynamic_array.c ../common/fastfmt.c
  * Run: ./ex01_dynamic_array
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include "../common/fastfmt.h"
 
 typedef struct {
     int *data;      // Pointer to the array data
@@ -84,13 +85,17 @@ void da_set(DynamicArray *arr, int index, int value) {
     // Optional: bounds checking
 }
 
+// Builds the whole line in a buffer: one write instead of a printf per element
 void da_print(DynamicArray *arr) {
-    printf("[");
+    FmtSink out;
+    fmt_sink_init(&out, stdout);
+    fmt_char(&out, '[');
     for (int i = 0; i < arr->size; i++) {
-        printf("%d", arr->data[i]);
-        if (i < arr->size - 1) printf(", ");
+        fmt_i64(&out, arr->data[i]);
+        if (i < arr->size - 1) fmt_str(&out, ", ");
     }
-    printf("]\n");
+    fmt_str(&out, "]\n");
+    fmt_flush(&out);
 }
 
 void da_free(DynamicArray *arr) {
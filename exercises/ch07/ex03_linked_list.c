@@ -6,12 +6,13 @@
  * This is a fundamental data structure that doesn't exist built-in to C.
  * It demonstrates dynamic memory allocation and pointer manipulation.
  *
- * Compile: cc -Wall -o ex03_linked_list ex03_linked_list.c
+ * Compile: cc -Wall -o ex03_linked_list ex03_linked_list.c ../common/fastfmt.c
  * Run: ./ex03_linked_list
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include "../common/fastfmt.h"
 
 typedef struct Node {
     int data;
@@ -79,16 +80,19 @@ void list_prepend(LinkedList *list, int value) {
 }
 
 void list_print(LinkedList *list) {
-    printf("[");
+    FmtSink out;
+    fmt_sink_init(&out, stdout);
+    fmt_char(&out, '[');
     Node *current = list->head;
     while (current != NULL) {
-        printf("%d", current->data);
+        fmt_i64(&out, current->data);
         if (current->next != NULL) {
-            printf(" -> ");
+            fmt_str(&out, " -> ");
         }
         current = current->next;
     }
-    printf("]\n");
+    fmt_str(&out, "]\n");
+    fmt_flush(&out);
 }
 
 int list_length(LinkedList *list) {
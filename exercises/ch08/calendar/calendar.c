@@ -0,0 +1,67 @@
+/*
+ * calendar.c - Table-driven calendar functions
+ *
+ * Every function here is a few lookups into the generated tables. Out of
+ * range inputs are not rejected with if statements; they are masked to
+ * index 0, whose table entries are chosen to fail the checks.
+ */
+
+#include "calendar.h"
+#include "calendar_tables.h"
+
+#define CAL_YEARS (CAL_MAX_YEAR - CAL_MIN_YEAR + 1)
+
+// Mask an out-of-range year down to 0 (never a leap year, never valid)
+static inline int clamp_year(int year) {
+    int in_range = (unsigned)(year - CAL_MIN_YEAR) < CAL_YEARS;
+    return year & -in_range;
+}
+
+static inline int leap_bit(int year) {
+    return (int)((cal_leap_bitmap[year >> 6] >> (year & 63)) & 1);
+}
+
+int cal_is_leap_year(int year) {
+    return leap_bit(clamp_year(year));
+}
+
+int cal_days_in_month(int year, int month) {
+    int year_ok = (unsigned)(year - CAL_MIN_YEAR) < CAL_YEARS;
+    int month_ok = (unsigned)month < 16;
+    int length = cal_month_length[leap_bit(year & -year_ok)][month & -month_ok];
+    return length & -year_ok;
+}
+
+int cal_is_valid_date(Date d) {
+    int year_ok = (unsigned)(d.year - CAL_MIN_YEAR) < CAL_YEARS;
+    int month_ok = (unsigned)d.month < 16;
+    int max_day = cal_month_length[leap_bit(d.year & -year_ok)][d.month & -month_ok];
+    // (day - 1) < max_day means 1 <= day <= max_day
+    return year_ok & ((unsigned)(d.day - 1) < (unsigned)max_day);
+}
+
+DaySerial cal_date_to_days(Date d) {
+    int leap = leap_bit(d.year);
+    return cal_days_before_year[d.year] + cal_days_before_month[leap][d.month]
+           + d.day - 1 - CAL_EPOCH_OFFSET;
+}
+
+Date cal_days_to_date(DaySerial days) {
+    int32_t s = days + CAL_EPOCH_OFFSET;  // Days since 0001-01-01
+
+    // 400 years are exactly 146097 days, so this estimate is within one
+    // year; two table compares correct it either way
+    int year = (int)((int64_t)s * 400 / 146097) + 1;
+    year -= s < cal_days_before_year[year];
+    year += s >= cal_days_before_year[year + 1];
+
+    int leap = leap_bit(year);
+    int doy = s - cal_days_before_year[year];  // 0 .. 365
+
+    // Months are 28..31 days, so doy / 32 + 1 is the month or one short
+    int month = (doy >> 5) + 1;
+    month += doy >= cal_days_before_month[leap][month + 1];
+
+    Date d = {year, month, doy - cal_days_before_month[leap][month] + 1};
+    return d;
+}
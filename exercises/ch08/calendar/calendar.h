@@ -0,0 +1,38 @@
+/*
+ * calendar.h - Table-driven calendar functions
+ *
+ * The tables these functions use are generated at build time by
+ * gen_tables.c (see the Makefile), so the answers come from array
+ * lookups instead of branches and modulo.
+ */
+
+#ifndef CALENDAR_H
+#define CALENDAR_H
+
+#include <stdint.h>
+
+// Supported year range (the generated tables cover exactly this)
+#define CAL_MIN_YEAR 1
+#define CAL_MAX_YEAR 9999
+
+typedef struct {
+    int year;
+    int month;
+    int day;
+} Date;
+
+// Days since 1970-01-01 (negative before it)
+typedef int32_t DaySerial;
+
+// Function prototypes
+// Years outside CAL_MIN_YEAR..CAL_MAX_YEAR are treated as invalid
+int cal_is_leap_year(int year);              // 0 for an invalid year
+int cal_days_in_month(int year, int month);  // 0 for an invalid year or month
+int cal_is_valid_date(Date d);
+
+// d must be valid (see cal_is_valid_date)
+DaySerial cal_date_to_days(Date d);
+// days must fall inside the supported year range
+Date cal_days_to_date(DaySerial days);
+
+#endif
@@ -0,0 +1,96 @@
+/*
+ * gen_tables.c - Generate calendar_tables.h
+ *
+ * Run by the Makefile before calendar.c is compiled. It uses the plain
+ * branching rules from Exercise 8.3 once, at build time, and writes the
+ * results out as C arrays:
+ *
+ *   cal_days_before_month[leap][m]  cumulative days before month m
+ *                                   (index 13 is the length of the year)
+ *   cal_month_length[leap][m]       days in month m, 0 for m = 0, 13..15
+ *   cal_days_before_year[y]         days from 0001-01-01 to y-01-01
+ *   cal_leap_bitmap[]               one bit per year, packed in uint64_t
+ *
+ * Usage: ./gen_tables > calendar_tables.h
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include "calendar.h"
+
+static int is_leap_year(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+static int days_in_month(int year, int month) {
+    static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month < 1 || month > 12) {
+        return 0;
+    }
+    return days[month - 1] + (month == 2 && is_leap_year(year));
+}
+
+int main(void) {
+    // A known non-leap and leap year stand in for the two table rows
+    const int sample_year[2] = {2023, 2024};
+
+    printf("/* Generated by gen_tables.c - do not edit. */\n\n");
+    printf("#ifndef CALENDAR_TABLES_H\n#define CALENDAR_TABLES_H\n\n");
+    printf("#include <stdint.h>\n\n");
+
+    printf("static const uint16_t cal_days_before_month[2][14] = {\n");
+    for (int leap = 0; leap < 2; leap++) {
+        printf("    {0");
+        int total = 0;
+        for (int m = 1; m <= 13; m++) {
+            printf(", %d", total);
+            total += days_in_month(sample_year[leap], m);
+        }
+        printf("},\n");
+    }
+    printf("};\n\n");
+
+    printf("static const uint8_t cal_month_length[2][16] = {\n");
+    for (int leap = 0; leap < 2; leap++) {
+        printf("    {");
+        for (int m = 0; m < 16; m++) {
+            printf("%s%d", m ? ", " : "", days_in_month(sample_year[leap], m));
+        }
+        printf("},\n");
+    }
+    printf("};\n\n");
+
+    // Entries 0 .. CAL_MAX_YEAR + 1, so year + 1 is always a valid index
+    printf("static const int32_t cal_days_before_year[%d] = {\n", CAL_MAX_YEAR + 2);
+    int64_t days = 0;
+    printf("    0,");
+    for (int y = 1; y <= CAL_MAX_YEAR + 1; y++) {
+        printf("%s%lld,", (y % 8 == 0) ? "\n    " : " ", (long long)days);
+        days += is_leap_year(y) ? 366 : 365;
+    }
+    printf("\n};\n\n");
+
+    int words = (CAL_MAX_YEAR + 64) / 64;
+    printf("static const uint64_t cal_leap_bitmap[%d] = {\n", words);
+    for (int w = 0; w < words; w++) {
+        uint64_t bits = 0;
+        for (int b = 0; b < 64; b++) {
+            int y = w * 64 + b;
+            if (y >= CAL_MIN_YEAR && y <= CAL_MAX_YEAR && is_leap_year(y)) {
+                bits |= (uint64_t)1 << b;
+            }
+        }
+        printf("    0x%016llxULL,\n", (unsigned long long)bits);
+    }
+    printf("};\n\n");
+
+    // Serial day 0 is 1970-01-01
+    int64_t epoch = 0;
+    for (int y = 1; y < 1970; y++) {
+        epoch += is_leap_year(y) ? 366 : 365;
+    }
+    printf("#define CAL_EPOCH_OFFSET %lld\n\n", (long long)epoch);
+
+    printf("#endif\n");
+    return 0;
+}
@@ -0,0 +1,236 @@
+/*
+ * Exercise 8.11: Build-Time Calendar Tables
+ *
+ * is_leap_year and days_in_month from Exercise 8.3 recompute the same
+ * answers with branches and modulo on every call. There are only 9999
+ * years and 12 months, so the Makefile runs a small generator program
+ * (gen_tables.c) that writes every answer into calendar_tables.h before
+ * the rest of the code is compiled.
+ *
+ *   make            # builds gen_tables, generates the header, builds calendar
+ *   ./calendar
+ *
+ * Python equivalent of the generator step:
+ *   with open("calendar_tables.h", "w") as f:
+ *       f.write(f"static const int days_before_year[] = {{{', '.join(...)}}};")
+ *
+ * This program checks the table-driven functions against the branching
+ * ones for every date in 0001-01-01 .. 9999-12-31 and benchmarks both.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "calendar.h"
+
+#define BENCH_COUNT 10000000
+
+// The branching versions (from Exercise 8.3)
+int is_leap_year(int year);
+int days_in_month(int year, int month);
+int is_valid_date(Date d);
+DaySerial date_to_days(Date d);
+
+int check_all_dates(void);
+void benchmark(void);
+
+int main(void) {
+    Date samples[] = {
+        {2024, 2, 29}, {2023, 2, 29}, {1900, 2, 29}, {2000, 2, 29},
+        {2024, 4, 31}, {2024, 13, 1}, {0, 1, 1}, {1970, 1, 1},
+    };
+    int count = sizeof(samples) / sizeof(samples[0]);
+
+    printf("=== Table Lookups ===\n");
+    for (int i = 0; i < count; i++) {
+        Date d = samples[i];
+        printf("%04d-%02d-%02d  leap=%d  days_in_month=%2d  %-7s",
+               d.year, d.month, d.day, cal_is_leap_year(d.year),
+               cal_days_in_month(d.year, d.month),
+               cal_is_valid_date(d) ? "valid" : "invalid");
+        if (cal_is_valid_date(d)) {
+            printf("  serial=%d", cal_date_to_days(d));
+        }
+        printf("\n");
+    }
+
+    if (!check_all_dates()) {
+        return 1;
+    }
+    benchmark();
+    return 0;
+}
+
+// --- Branching versions ---
+// Marked noinline so the benchmark compares like with like: the table
+// versions live in calendar.c and are also reached through a call.
+
+__attribute__((noinline)) int is_leap_year(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+__attribute__((noinline)) int days_in_month(int year, int month) {
+    static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month < 1 || month > 12) {
+        return 0;
+    }
+    return days[month - 1] + (month == 2 && is_leap_year(year));
+}
+
+__attribute__((noinline)) int is_valid_date(Date d) {
+    return d.year >= CAL_MIN_YEAR && d.year <= CAL_MAX_YEAR
+           && d.day >= 1 && d.day <= days_in_month(d.year, d.month);
+}
+
+// Count whole years, then months, from 1970-01-01
+__attribute__((noinline)) DaySerial date_to_days(Date d) {
+    DaySerial days = 0;
+    if (d.year >= 1970) {
+        for (int y = 1970; y < d.year; y++) {
+            days += is_leap_year(y) ? 366 : 365;
+        }
+    } else {
+        for (int y = d.year; y < 1970; y++) {
+            days -= is_leap_year(y) ? 366 : 365;
+        }
+    }
+    for (int m = 1; m < d.month; m++) {
+        days += days_in_month(d.year, m);
+    }
+    return days + d.day - 1;
+}
+
+// --- Verification ---
+
+// Walk every day of the supported range and compare both directions.
+// Returns 1 if everything matches.
+int check_all_dates(void) {
+    Date d = {CAL_MIN_YEAR, 1, 1};
+    DaySerial serial = date_to_days(d);
+    long checked = 0, mismatches = 0;
+
+    while (d.year <= CAL_MAX_YEAR) {
+        Date back = cal_days_to_date(serial);
+        if (cal_date_to_days(d) != serial || back.year != d.year
+            || back.month != d.month || back.day != d.day
+            || !cal_is_valid_date(d)) {
+            mismatches++;
+        }
+        checked++;
+        serial++;
+        if (++d.day > days_in_month(d.year, d.month)) {
+            d.day = 1;
+            if (++d.month > 12) {
+                d.month = 1;
+                d.year++;
+            }
+        }
+    }
+
+    // Validation must agree on junk too, including the out-of-range values
+    for (int y = -1; y <= CAL_MAX_YEAR + 1; y += 7) {
+        for (int m = -1; m <= 17; m++) {
+            for (int day = -1; day <= 33; day++) {
+                Date t = {y, m, day};
+                mismatches += cal_is_valid_date(t) != is_valid_date(t);
+                checked++;
+            }
+        }
+    }
+
+    printf("\nChecked %ld dates: %ld mismatches\n", checked, mismatches);
+    return mismatches == 0;
+}
+
+// --- Benchmark ---
+
+static double elapsed_ms(clock_t start, clock_t end) {
+    return (double)(end - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+void benchmark(void) {
+    Date *dates = malloc(BENCH_COUNT * sizeof(Date));
+    if (dates == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return;
+    }
+
+    // Mostly valid dates with some junk mixed in, from years 1900-2100
+    srand(39);
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        dates[i].year = 1900 + rand() % 200;
+        dates[i].month = 1 + rand() % 12;
+        dates[i].day = 1 + rand() % 31;
+    }
+
+    printf("\n=== Benchmark: %d dates ===\n", BENCH_COUNT);
+    clock_t start, end;
+    long sink;
+
+    start = clock();
+    sink = 0;
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        sink += is_leap_year(dates[i].year) + days_in_month(dates[i].year, dates[i].month);
+    }
+    end = clock();
+    printf("%-36s %8.1f ms  (%ld)\n", "is_leap_year + days_in_month", elapsed_ms(start, end), sink);
+
+    start = clock();
+    sink = 0;
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        sink += cal_is_leap_year(dates[i].year) + cal_days_in_month(dates[i].year, dates[i].month);
+    }
+    end = clock();
+    printf("%-36s %8.1f ms  (%ld)\n", "cal_is_leap_year + cal_days_in_month",
+           elapsed_ms(start, end), sink);
+
+    start = clock();
+    sink = 0;
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        sink += is_valid_date(dates[i]);
+    }
+    end = clock();
+    printf("%-36s %8.1f ms  (%ld valid)\n", "is_valid_date", elapsed_ms(start, end), sink);
+
+    start = clock();
+    sink = 0;
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        sink += cal_is_valid_date(dates[i]);
+    }
+    end = clock();
+    printf("%-36s %8.1f ms  (%ld valid)\n", "cal_is_valid_date", elapsed_ms(start, end), sink);
+
+    // Clamp the days so every date is valid for the conversions
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        if (dates[i].day > days_in_month(dates[i].year, dates[i].month)) {
+            dates[i].day = days_in_month(dates[i].year, dates[i].month);
+        }
+    }
+
+    start = clock();
+    sink = 0;
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        sink += date_to_days(dates[i]);
+    }
+    end = clock();
+    printf("%-36s %8.1f ms  (%ld)\n", "date_to_days (loops)", elapsed_ms(start, end), sink);
+
+    start = clock();
+    sink = 0;
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        sink += cal_date_to_days(dates[i]);
+    }
+    end = clock();
+    printf("%-36s %8.1f ms  (%ld)\n", "cal_date_to_days", elapsed_ms(start, end), sink);
+
+    start = clock();
+    sink = 0;
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        Date d = cal_days_to_date(i % 73000 - 25000);
+        sink += d.year + d.month + d.day;
+    }
+    end = clock();
+    printf("%-36s %8.1f ms  (%ld)\n", "cal_days_to_date", elapsed_ms(start, end), sink);
+
+    free(dates);
+}
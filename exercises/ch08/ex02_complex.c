@@ -13,12 +13,13 @@
  *   (a + bi) - (c + di) = (a-c) + (b-d)i
  *   (a + bi) * (c + di) = (ac - bd) + (ad + bc)i
  *
- * Compile: cc -Wall -o ex02_complex ex02_complex.c -lm
+ * Compile: cc -Wall -o ex02_complex ex02_complex.c ../common/fastfmt.c -lm
  * Run: ./ex02_complex
  */
 
 #include <stdio.h>
 #include <math.h>
+#include "../common/fastfmt.h"
 
 typedef struct {
     double real;
@@ -90,9 +91,16 @@ double complex_magnitude(Complex c) {
 
 void complex_print(Complex c) {
     // Print in format: "3.00 + 4.00i" or "3.00 - 4.00i"
+    FmtSink out;
+    fmt_sink_init(&out, stdout);
+    fmt_fixed(&out, c.real, 2);
     if (c.imag >= 0) {
-        printf("%.2f + %.2fi\n", c.real, c.imag);
+        fmt_str(&out, " + ");
+        fmt_fixed(&out, c.imag, 2);
     } else {
-        printf("%.2f - %.2fi\n", c.real, -c.imag);
+        fmt_str(&out, " - ");
+        fmt_fixed(&out, -c.imag, 2);
     }
+    fmt_str(&out, "i\n");
+    fmt_flush(&out);
 }
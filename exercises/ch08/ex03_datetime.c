@@ -3,11 +3,12 @@
  *
  * Create a Date struct with comparison and validation functions.
  *
- * Compile: cc -Wall -o ex03_datetime ex03_datetime.c
+ * Compile: cc -Wall -o ex03_datetime ex03_datetime.c ../common/fastfmt.c
  * Run: ./ex03_datetime
  */
 
 #include <stdio.h>
+#include "../common/fastfmt.h"
 
 typedef struct {
     int year;
@@ -104,5 +105,12 @@ int compare_dates(Date a, Date b) {
 }
 
 void print_date(Date d) {
-    printf("%04d-%02d-%02d", d.year, d.month, d.day);
+    FmtSink out;
+    fmt_sink_init(&out, stdout);
+    fmt_i64_zero_pad(&out, d.year, 4);
+    fmt_char(&out, '-');
+    fmt_i64_zero_pad(&out, d.month, 2);
+    fmt_char(&out, '-');
+    fmt_i64_zero_pad(&out, d.day, 2);
+    fmt_flush(&out);
 }
@@ -0,0 +1,536 @@
+/*
+ * Exercise 8.5: Indexed Student Database
+ *
+ * Exercise 8.1's find_by_id() and find_highest_gpa() scan the whole
+ * array on every call. That is fine for 5 students and hopeless for
+ * millions. This version keeps two indexes next to the records, the way
+ * a database does:
+ *
+ *   - An id index: an open-addressing hash table mapping id -> slot in
+ *     the records array. Lookups are O(1) on average.
+ *   - A GPA index: a skip list ordered by GPA (highest first). Top-K is
+ *     "walk the first K nodes" and "all students with GPA >= 3.7" is
+ *     "walk until the GPA drops below 3.7".
+ *
+ * Both indexes are updated on every insert and delete, so they never
+ * need to be rebuilt.
+ *
+ * Python version:
+ *   by_id = {s.id: s for s in students}          # id index
+ *   by_gpa = sortedcontainers.SortedList(...)    # GPA index
+ *   by_id.get(1003)
+ *   [s for s in by_gpa.irange(3.7, None)]
+ *
+ * Note: pointers returned by db_find_by_id() and friends are only valid
+ * until the next insert or delete, like iterators into a Python list
+ * you then modify.
+ *
+ * Compile: cc -Wall -O2 -o ex05_student_index ex05_student_index.c
+ * Run: ./ex05_student_index
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SKIP_MAX_LEVEL 24        // Enough for ~16 million records
+#define HASH_EMPTY (-1)
+#define BENCH_STUDENTS 1000000
+#define BENCH_LOOKUPS 1000000
+
+typedef struct {
+    char name[50];
+    int id;
+    double gpa;
+} Student;
+
+// --- Id index: id -> slot, linear probing ---
+
+typedef struct {
+    int id;
+    int slot;    // HASH_EMPTY marks an unused bucket
+} IdBucket;
+
+typedef struct {
+    IdBucket *buckets;
+    size_t capacity;   // Always a power of two
+    size_t size;
+} IdIndex;
+
+// --- GPA index: skip list, highest GPA first, ties by ascending id ---
+
+typedef struct GpaNode {
+    double gpa;
+    int id;
+    int level;
+    struct GpaNode *next[];   // One forward pointer per level
+} GpaNode;
+
+typedef struct {
+    GpaNode *head;   // Sentinel with SKIP_MAX_LEVEL pointers
+    int level;       // Highest level currently in use
+    unsigned int rng;
+} GpaIndex;
+
+typedef struct {
+    Student *records;
+    int count;
+    int capacity;
+    IdIndex by_id;
+    GpaIndex by_gpa;
+} StudentDb;
+
+// Function prototypes
+int db_init(StudentDb *db);
+int db_insert(StudentDb *db, const Student *s);
+int db_delete(StudentDb *db, int id);
+Student *db_find_by_id(StudentDb *db, int id);
+Student *db_find_highest_gpa(StudentDb *db);
+int db_top_gpa(StudentDb *db, Student **out, int k);
+int db_gpa_at_least(StudentDb *db, double min_gpa, Student **out, int max_out);
+void db_free(StudentDb *db);
+
+void print_student(Student s);
+Student *find_by_id_linear(Student students[], int count, int id);
+void benchmark(void);
+
+int main(void) {
+    Student students[] = {
+        {"Alice Johnson", 1001, 3.8},
+        {"Bob Smith", 1002, 3.5},
+        {"Charlie Brown", 1003, 3.9},
+        {"Diana Ross", 1004, 3.7},
+        {"Eve Williams", 1005, 4.0}
+    };
+    int count = sizeof(students) / sizeof(students[0]);
+
+    StudentDb db;
+    if (!db_init(&db)) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    for (int i = 0; i < count; i++) {
+        db_insert(&db, &students[i]);
+    }
+
+    printf("=== Indexed Student Database ===\n\n");
+
+    printf("Student with highest GPA:\n");
+    Student *top = db_find_highest_gpa(&db);
+    if (top != NULL) {
+        print_student(*top);
+    }
+
+    printf("\nSearching for student ID 1003:\n");
+    Student *found = db_find_by_id(&db, 1003);
+    if (found != NULL) {
+        print_student(*found);
+    } else {
+        printf("Student not found.\n");
+    }
+
+    printf("\nTop 3 by GPA:\n");
+    Student *results[10];
+    int n = db_top_gpa(&db, results, 3);
+    for (int i = 0; i < n; i++) {
+        print_student(*results[i]);
+    }
+
+    printf("\nAll students with GPA >= 3.7:\n");
+    n = db_gpa_at_least(&db, 3.7, results, 10);
+    for (int i = 0; i < n; i++) {
+        print_student(*results[i]);
+    }
+
+    printf("\nDeleting 1005 (Eve) and adding 1006 (Frank, 3.95)...\n");
+    db_delete(&db, 1005);
+    Student frank = {"Frank Miller", 1006, 3.95};
+    db_insert(&db, &frank);
+
+    printf("Student with highest GPA:\n");
+    top = db_find_highest_gpa(&db);
+    if (top != NULL) {
+        print_student(*top);
+    }
+    printf("Searching for student ID 1005: %s\n",
+           db_find_by_id(&db, 1005) ? "found" : "not found");
+
+    db_free(&db);
+
+    benchmark();
+    return 0;
+}
+
+void print_student(Student s) {
+    printf("ID: %d, Name: %s, GPA: %.2f\n", s.id, s.name, s.gpa);
+}
+
+// --- Id index ---
+
+static size_t hash_id(int id, size_t capacity) {
+    // Fibonacci hashing: multiply by 2^64 / phi and keep the high bits
+    unsigned long long h = (unsigned long long)(unsigned int)id * 11400714819323198485ull;
+    return (size_t)(h >> 32) & (capacity - 1);
+}
+
+static int id_index_init(IdIndex *ix, size_t capacity) {
+    ix->buckets = malloc(capacity * sizeof(IdBucket));
+    if (ix->buckets == NULL) {
+        return 0;
+    }
+    for (size_t i = 0; i < capacity; i++) {
+        ix->buckets[i].slot = HASH_EMPTY;
+    }
+    ix->capacity = capacity;
+    ix->size = 0;
+    return 1;
+}
+
+// Bucket holding id, or the empty bucket where it would go
+static size_t id_index_probe(const IdIndex *ix, int id) {
+    size_t i = hash_id(id, ix->capacity);
+    while (ix->buckets[i].slot != HASH_EMPTY && ix->buckets[i].id != id) {
+        i = (i + 1) & (ix->capacity - 1);
+    }
+    return i;
+}
+
+static int id_index_get(const IdIndex *ix, int id) {
+    return ix->buckets[id_index_probe(ix, id)].slot;
+}
+
+static int id_index_put(IdIndex *ix, int id, int slot) {
+    // Grow at 50% load: linear probing degrades quickly past that
+    if ((ix->size + 1) * 2 > ix->capacity) {
+        IdIndex bigger;
+        if (!id_index_init(&bigger, ix->capacity * 2)) {
+            return 0;
+        }
+        for (size_t i = 0; i < ix->capacity; i++) {
+            if (ix->buckets[i].slot != HASH_EMPTY) {
+                bigger.buckets[id_index_probe(&bigger, ix->buckets[i].id)] = ix->buckets[i];
+                bigger.size++;
+            }
+        }
+        free(ix->buckets);
+        *ix = bigger;
+    }
+    size_t i = id_index_probe(ix, id);
+    if (ix->buckets[i].slot == HASH_EMPTY) {
+        ix->size++;
+    }
+    ix->buckets[i].id = id;
+    ix->buckets[i].slot = slot;
+    return 1;
+}
+
+// Point an id that is already in the index at a new slot. Unlike
+// id_index_put this never has to grow, so it cannot fail.
+static void id_index_move(IdIndex *ix, int id, int slot) {
+    ix->buckets[id_index_probe(ix, id)].slot = slot;
+}
+
+static void id_index_remove(IdIndex *ix, int id) {
+    size_t mask = ix->capacity - 1;
+    size_t hole = id_index_probe(ix, id);
+    if (ix->buckets[hole].slot == HASH_EMPTY) {
+        return;
+    }
+    ix->size--;
+
+    // Backward-shift deletion: pull later entries of the same probe run
+    // into the hole so lookups never need "deleted" markers.
+    size_t i = hole;
+    while (1) {
+        i = (i + 1) & mask;
+        if (ix->buckets[i].slot == HASH_EMPTY) {
+            break;
+        }
+        size_t home = hash_id(ix->buckets[i].id, ix->capacity);
+        // Move it if its home is not in the (cyclic) range (hole, i]
+        int between = (hole <= i) ? (hole < home && home <= i)
+                                  : (hole < home || home <= i);
+        if (!between) {
+            ix->buckets[hole] = ix->buckets[i];
+            hole = i;
+        }
+    }
+    ix->buckets[hole].slot = HASH_EMPTY;
+}
+
+// --- GPA index ---
+
+// 1 if node sorts strictly before (gpa, id) in the index
+static int node_before(const GpaNode *node, double gpa, int id) {
+    if (node->gpa != gpa) {
+        return node->gpa > gpa;
+    }
+    return node->id < id;
+}
+
+static int gpa_index_init(GpaIndex *ix) {
+    ix->head = calloc(1, sizeof(GpaNode) + SKIP_MAX_LEVEL * sizeof(GpaNode *));
+    ix->level = 1;
+    ix->rng = 12345u;
+    return ix->head != NULL;
+}
+
+static int gpa_random_level(GpaIndex *ix) {
+    // Each level is kept with probability 1/4 (xorshift32 for the coin)
+    int level = 1;
+    while (level < SKIP_MAX_LEVEL) {
+        ix->rng ^= ix->rng << 13;
+        ix->rng ^= ix->rng >> 17;
+        ix->rng ^= ix->rng << 5;
+        if ((ix->rng & 3) != 0) {
+            break;
+        }
+        level++;
+    }
+    return level;
+}
+
+// Fill update[] with the last node before (gpa, id) on every level
+static void gpa_find_path(GpaIndex *ix, double gpa, int id, GpaNode **update) {
+    GpaNode *x = ix->head;
+    for (int lv = ix->level - 1; lv >= 0; lv--) {
+        while (x->next[lv] != NULL && node_before(x->next[lv], gpa, id)) {
+            x = x->next[lv];
+        }
+        update[lv] = x;
+    }
+}
+
+static int gpa_index_insert(GpaIndex *ix, double gpa, int id) {
+    GpaNode *update[SKIP_MAX_LEVEL];
+    gpa_find_path(ix, gpa, id, update);
+
+    int level = gpa_random_level(ix);
+    GpaNode *node = malloc(sizeof(GpaNode) + level * sizeof(GpaNode *));
+    if (node == NULL) {
+        return 0;
+    }
+    node->gpa = gpa;
+    node->id = id;
+    node->level = level;
+    for (int lv = ix->level; lv < level; lv++) {
+        update[lv] = ix->head;
+    }
+    if (level > ix->level) {
+        ix->level = level;
+    }
+    for (int lv = 0; lv < level; lv++) {
+        node->next[lv] = update[lv]->next[lv];
+        update[lv]->next[lv] = node;
+    }
+    return 1;
+}
+
+static void gpa_index_remove(GpaIndex *ix, double gpa, int id) {
+    GpaNode *update[SKIP_MAX_LEVEL];
+    gpa_find_path(ix, gpa, id, update);
+
+    GpaNode *node = update[0]->next[0];
+    if (node == NULL || node->gpa != gpa || node->id != id) {
+        return;
+    }
+    for (int lv = 0; lv < node->level; lv++) {
+        update[lv]->next[lv] = node->next[lv];
+    }
+    free(node);
+    while (ix->level > 1 && ix->head->next[ix->level - 1] == NULL) {
+        ix->level--;
+    }
+}
+
+static void gpa_index_free(GpaIndex *ix) {
+    GpaNode *x = ix->head;
+    while (x != NULL) {
+        GpaNode *next = x->next[0];
+        free(x);
+        x = next;
+    }
+    ix->head = NULL;
+}
+
+// --- Database ---
+
+int db_init(StudentDb *db) {
+    db->count = 0;
+    db->capacity = 16;
+    db->records = malloc(db->capacity * sizeof(Student));
+    if (db->records == NULL) {
+        return 0;
+    }
+    if (!id_index_init(&db->by_id, 32)) {
+        free(db->records);
+        return 0;
+    }
+    if (!gpa_index_init(&db->by_gpa)) {
+        free(db->records);
+        free(db->by_id.buckets);
+        return 0;
+    }
+    return 1;
+}
+
+// Returns 1 on success, 0 if the id already exists or memory runs out
+int db_insert(StudentDb *db, const Student *s) {
+    if (id_index_get(&db->by_id, s->id) != HASH_EMPTY) {
+        return 0;
+    }
+    if (db->count == db->capacity) {
+        Student *bigger = realloc(db->records, 2 * db->capacity * sizeof(Student));
+        if (bigger == NULL) {
+            return 0;
+        }
+        db->records = bigger;
+        db->capacity *= 2;
+    }
+    if (!gpa_index_insert(&db->by_gpa, s->gpa, s->id)) {
+        return 0;
+    }
+    if (!id_index_put(&db->by_id, s->id, db->count)) {
+        gpa_index_remove(&db->by_gpa, s->gpa, s->id);
+        return 0;
+    }
+    db->records[db->count++] = *s;
+    return 1;
+}
+
+// Returns 1 if a student was removed
+int db_delete(StudentDb *db, int id) {
+    int slot = id_index_get(&db->by_id, id);
+    if (slot == HASH_EMPTY) {
+        return 0;
+    }
+    gpa_index_remove(&db->by_gpa, db->records[slot].gpa, id);
+    id_index_remove(&db->by_id, id);
+
+    // Keep records dense: move the last record into the freed slot
+    int last = db->count - 1;
+    if (slot != last) {
+        db->records[slot] = db->records[last];
+        id_index_move(&db->by_id, db->records[slot].id, slot);
+    }
+    db->count--;
+    return 1;
+}
+
+Student *db_find_by_id(StudentDb *db, int id) {
+    int slot = id_index_get(&db->by_id, id);
+    return slot == HASH_EMPTY ? NULL : &db->records[slot];
+}
+
+Student *db_find_highest_gpa(StudentDb *db) {
+    GpaNode *first = db->by_gpa.head->next[0];
+    return first == NULL ? NULL : db_find_by_id(db, first->id);
+}
+
+// Up to k students, highest GPA first. Returns how many were written.
+int db_top_gpa(StudentDb *db, Student **out, int k) {
+    int n = 0;
+    for (GpaNode *x = db->by_gpa.head->next[0]; x != NULL && n < k; x = x->next[0]) {
+        out[n++] = db_find_by_id(db, x->id);
+    }
+    return n;
+}
+
+// Students with gpa >= min_gpa, highest first, up to max_out of them.
+// Returns how many were written.
+int db_gpa_at_least(StudentDb *db, double min_gpa, Student **out, int max_out) {
+    int n = 0;
+    for (GpaNode *x = db->by_gpa.head->next[0];
+         x != NULL && x->gpa >= min_gpa && n < max_out;
+         x = x->next[0]) {
+        out[n++] = db_find_by_id(db, x->id);
+    }
+    return n;
+}
+
+void db_free(StudentDb *db) {
+    free(db->records);
+    free(db->by_id.buckets);
+    gpa_index_free(&db->by_gpa);
+    db->records = NULL;
+    db->count = 0;
+    db->capacity = 0;
+}
+
+// --- Benchmark ---
+
+Student *find_by_id_linear(Student students[], int count, int id) {
+    for (int i = 0; i < count; i++) {
+        if (students[i].id == id) {
+            return &students[i];
+        }
+    }
+    return NULL;
+}
+
+void benchmark(void) {
+    printf("\n=== Benchmark: %d students ===\n", BENCH_STUDENTS);
+
+    StudentDb db;
+    if (!db_init(&db)) {
+        fprintf(stderr, "Out of memory\n");
+        return;
+    }
+
+    srand(7);
+    clock_t start = clock();
+    for (int i = 0; i < BENCH_STUDENTS; i++) {
+        Student s;
+        snprintf(s.name, sizeof(s.name), "Student %d", i);
+        s.id = 100000 + i * 7;
+        s.gpa = (rand() % 401) / 100.0;
+        if (!db_insert(&db, &s)) {
+            fprintf(stderr, "Insert failed\n");
+            db_free(&db);
+            return;
+        }
+    }
+    clock_t end = clock();
+    printf("Insert (both indexes): %.3f s\n", (double)(end - start) / CLOCKS_PER_SEC);
+
+    long found = 0;
+    start = clock();
+    for (int i = 0; i < BENCH_LOOKUPS; i++) {
+        int id = 100000 + (rand() % BENCH_STUDENTS) * 7;
+        found += db_find_by_id(&db, id) != NULL;
+    }
+    end = clock();
+    double hashed = (double)(end - start) / CLOCKS_PER_SEC;
+    printf("Hash lookups:   %d in %.3f s (%.0f per second)\n",
+           BENCH_LOOKUPS, hashed, hashed > 0 ? BENCH_LOOKUPS / hashed : 0.0);
+
+    // The linear scan is so slow that we only time a few hundred
+    int linear_lookups = 200;
+    start = clock();
+    for (int i = 0; i < linear_lookups; i++) {
+        int id = 100000 + (rand() % BENCH_STUDENTS) * 7;
+        found += find_by_id_linear(db.records, db.count, id) != NULL;
+    }
+    end = clock();
+    double linear = (double)(end - start) / CLOCKS_PER_SEC;
+    printf("Linear lookups: %d in %.3f s (%.0f per second)\n",
+           linear_lookups, linear, linear > 0 ? linear_lookups / linear : 0.0);
+
+    Student *results[10];
+    start = clock();
+    int n = db_gpa_at_least(&db, 3.99, results, 10);
+    end = clock();
+    printf("GPA >= 3.99 (first %d): %.6f s\n", n, (double)(end - start) / CLOCKS_PER_SEC);
+
+    start = clock();
+    for (int i = 0; i < BENCH_STUDENTS / 2; i++) {
+        db_delete(&db, 100000 + i * 7);
+    }
+    end = clock();
+    printf("Delete %d:   %.3f s, %d left\n", BENCH_STUDENTS / 2,
+           (double)(end - start) / CLOCKS_PER_SEC, db.count);
+    printf("(%ld lookups hit)\n", found);
+
+    db_free(&db);
+}
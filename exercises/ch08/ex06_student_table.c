@@ -0,0 +1,382 @@
+/*
+ * Exercise 8.6: Column Storage for Students (Structure of Arrays)
+ *
+ * Exercise 8.1 stores students as an "array of structs" (AoS):
+ *
+ *   [name(50) id gpa][name(50) id gpa][name(50) id gpa] ...
+ *
+ * Each Student is 64 bytes, so finding the highest GPA reads 64 bytes per
+ * student to use 8 of them. A "struct of arrays" (SoA) keeps each field
+ * in its own array instead:
+ *
+ *   ids:   [id][id][id] ...
+ *   gpas:  [gpa][gpa][gpa] ...
+ *   names: "Alice JohnsonBob SmithCharlie Brown..."  + offsets
+ *
+ * A GPA scan now touches only the gpas array (8 bytes per student) and
+ * an id search only the ids array (4 bytes), and both are plain arrays
+ * of numbers that SIMD instructions can chew through 4 or 8 at a time.
+ * This is the same idea as a pandas DataFrame or a columnar database.
+ *
+ * Names are packed back to back in one "arena" buffer; name_offsets[i]
+ * and name_offsets[i + 1] bracket student i's name, so names take only
+ * as much space as they need.
+ *
+ * Python version:
+ *   df = pandas.DataFrame(students)
+ *   df["gpa"].idxmax()
+ *   df.index[df["id"] == 1003]
+ *
+ * Compile: cc -Wall -O2 -march=native -o ex06_student_table ex06_student_table.c
+ * Run: ./ex06_student_table
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#define BENCH_STUDENTS 4000000
+#define BENCH_REPEAT 10
+
+typedef struct {
+    char name[50];
+    int id;
+    double gpa;
+} Student;
+
+typedef struct {
+    int *ids;
+    double *gpas;
+    size_t *name_offsets;   // count + 1 entries; name i is [off[i], off[i+1])
+    char *names;            // All names back to back, no terminators
+    size_t names_used;
+    size_t names_capacity;
+    int count;
+    int capacity;
+} StudentTable;
+
+// Function prototypes
+int table_init(StudentTable *t, int capacity);
+int table_append(StudentTable *t, const char *name, int id, double gpa);
+int table_from_students(StudentTable *t, const Student students[], int count);
+void table_to_students(const StudentTable *t, Student out[]);
+void table_get(const StudentTable *t, int i, Student *out);
+int table_max_gpa(const StudentTable *t);
+int table_find_id(const StudentTable *t, int id);
+void table_free(StudentTable *t);
+
+void print_student(Student s);
+Student *find_highest_gpa(Student students[], int count);
+Student *find_by_id(Student students[], int count, int id);
+void benchmark(void);
+
+int main(void) {
+    Student students[] = {
+        {"Alice Johnson", 1001, 3.8},
+        {"Bob Smith", 1002, 3.5},
+        {"Charlie Brown", 1003, 3.9},
+        {"Diana Ross", 1004, 3.7},
+        {"Eve Williams", 1005, 4.0}
+    };
+    int count = sizeof(students) / sizeof(students[0]);
+
+    StudentTable t;
+    if (!table_from_students(&t, students, count)) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    printf("=== Student Table (SoA) ===\n\n");
+    printf("sizeof(Student) = %zu bytes; per student in the table: "
+           "%zu (id) + %zu (gpa) + name length + %zu (offset)\n\n",
+           sizeof(Student), sizeof(int), sizeof(double), sizeof(size_t));
+
+    Student s;
+    printf("Student with highest GPA:\n");
+    int best = table_max_gpa(&t);
+    if (best >= 0) {
+        table_get(&t, best, &s);
+        print_student(s);
+    }
+
+    printf("\nSearching for student ID 1003:\n");
+    int row = table_find_id(&t, 1003);
+    if (row >= 0) {
+        table_get(&t, row, &s);
+        print_student(s);
+    } else {
+        printf("Student not found.\n");
+    }
+
+    printf("\nRound trip back to Student[]:\n");
+    Student back[5];
+    table_to_students(&t, back);
+    for (int i = 0; i < count; i++) {
+        print_student(back[i]);
+    }
+
+    table_free(&t);
+
+    benchmark();
+    return 0;
+}
+
+void print_student(Student s) {
+    printf("ID: %d, Name: %s, GPA: %.2f\n", s.id, s.name, s.gpa);
+}
+
+// --- StudentTable ---
+
+int table_init(StudentTable *t, int capacity) {
+    if (capacity < 1) {
+        capacity = 1;
+    }
+    t->count = 0;
+    t->capacity = capacity;
+    t->names_used = 0;
+    t->names_capacity = (size_t)capacity * 16;
+    t->ids = malloc(capacity * sizeof(int));
+    t->gpas = malloc(capacity * sizeof(double));
+    t->name_offsets = malloc((capacity + 1) * sizeof(size_t));
+    t->names = malloc(t->names_capacity);
+    if (t->ids == NULL || t->gpas == NULL || t->name_offsets == NULL || t->names == NULL) {
+        table_free(t);
+        return 0;
+    }
+    t->name_offsets[0] = 0;
+    return 1;
+}
+
+int table_append(StudentTable *t, const char *name, int id, double gpa) {
+    if (t->count == t->capacity) {
+        int capacity = t->capacity * 2;
+        int *ids = realloc(t->ids, capacity * sizeof(int));
+        if (ids == NULL) return 0;
+        t->ids = ids;
+        double *gpas = realloc(t->gpas, capacity * sizeof(double));
+        if (gpas == NULL) return 0;
+        t->gpas = gpas;
+        size_t *offsets = realloc(t->name_offsets, (capacity + 1) * sizeof(size_t));
+        if (offsets == NULL) return 0;
+        t->name_offsets = offsets;
+        t->capacity = capacity;
+    }
+
+    size_t len = strlen(name);
+    if (t->names_used + len > t->names_capacity) {
+        size_t capacity = t->names_capacity * 2;
+        while (t->names_used + len > capacity) {
+            capacity *= 2;
+        }
+        char *names = realloc(t->names, capacity);
+        if (names == NULL) return 0;
+        t->names = names;
+        t->names_capacity = capacity;
+    }
+
+    memcpy(t->names + t->names_used, name, len);
+    t->names_used += len;
+    t->ids[t->count] = id;
+    t->gpas[t->count] = gpa;
+    t->count++;
+    t->name_offsets[t->count] = t->names_used;
+    return 1;
+}
+
+int table_from_students(StudentTable *t, const Student students[], int count) {
+    if (!table_init(t, count)) {
+        return 0;
+    }
+    for (int i = 0; i < count; i++) {
+        if (!table_append(t, students[i].name, students[i].id, students[i].gpa)) {
+            table_free(t);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void table_get(const StudentTable *t, int i, Student *out) {
+    size_t start = t->name_offsets[i];
+    size_t len = t->name_offsets[i + 1] - start;
+    if (len > sizeof(out->name) - 1) {
+        len = sizeof(out->name) - 1;   // Truncate like strncpy would
+    }
+    memcpy(out->name, t->names + start, len);
+    out->name[len] = '\0';
+    out->id = t->ids[i];
+    out->gpa = t->gpas[i];
+}
+
+void table_to_students(const StudentTable *t, Student out[]) {
+    for (int i = 0; i < t->count; i++) {
+        table_get(t, i, &out[i]);
+    }
+}
+
+// Row with the highest GPA (first one on ties), or -1 if empty
+int table_max_gpa(const StudentTable *t) {
+    if (t->count == 0) {
+        return -1;
+    }
+    const double *g = t->gpas;
+    int n = t->count;
+    int i = 0;
+    double best = g[0];
+
+#ifdef __AVX2__
+    // Find the maximum value 4 lanes at a time...
+    if (n >= 4) {
+        __m256d vmax = _mm256_loadu_pd(g);
+        for (i = 4; i + 4 <= n; i += 4) {
+            vmax = _mm256_max_pd(vmax, _mm256_loadu_pd(g + i));
+        }
+        __m128d m = _mm_max_pd(_mm256_castpd256_pd128(vmax), _mm256_extractf128_pd(vmax, 1));
+        m = _mm_max_pd(m, _mm_unpackhi_pd(m, m));
+        best = _mm_cvtsd_f64(m);
+    }
+#endif
+    for (; i < n; i++) {
+        best = g[i] > best ? g[i] : best;
+    }
+
+    // ...then find where it is (another sequential pass over 8-byte values)
+    i = 0;
+#ifdef __AVX2__
+    __m256d target = _mm256_set1_pd(best);
+    for (; i + 4 <= n; i += 4) {
+        int mask = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(g + i), target, _CMP_EQ_OQ));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        if (g[i] == best) {
+            return i;
+        }
+    }
+    return 0;   // Only reached if every GPA is NaN
+}
+
+// Row with the given id, or -1
+int table_find_id(const StudentTable *t, int id) {
+    const int *ids = t->ids;
+    int n = t->count;
+    int i = 0;
+
+#ifdef __AVX2__
+    __m256i target = _mm256_set1_epi32(id);
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(ids + i));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, target)));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        if (ids[i] == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void table_free(StudentTable *t) {
+    free(t->ids);
+    free(t->gpas);
+    free(t->name_offsets);
+    free(t->names);
+    t->ids = NULL;
+    t->gpas = NULL;
+    t->name_offsets = NULL;
+    t->names = NULL;
+    t->count = 0;
+    t->capacity = 0;
+}
+
+// --- AoS versions from Exercise 8.1, for comparison ---
+
+Student *find_highest_gpa(Student students[], int count) {
+    if (count == 0) {
+        return NULL;
+    }
+    Student *best = &students[0];
+    for (int i = 1; i < count; i++) {
+        if (students[i].gpa > best->gpa) {
+            best = &students[i];
+        }
+    }
+    return best;
+}
+
+Student *find_by_id(Student students[], int count, int id) {
+    for (int i = 0; i < count; i++) {
+        if (students[i].id == id) {
+            return &students[i];
+        }
+    }
+    return NULL;
+}
+
+void benchmark(void) {
+    printf("\n=== Benchmark: %d students, best of %d scans (ms) ===\n",
+           BENCH_STUDENTS, BENCH_REPEAT);
+
+    Student *aos = malloc((size_t)BENCH_STUDENTS * sizeof(Student));
+    if (aos == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return;
+    }
+    srand(3);
+    for (int i = 0; i < BENCH_STUDENTS; i++) {
+        snprintf(aos[i].name, sizeof(aos[i].name), "Student %d", i);
+        aos[i].id = 100000 + i;
+        aos[i].gpa = (rand() % 400) / 100.0;
+    }
+    aos[BENCH_STUDENTS * 3 / 4].gpa = 4.0;   // Unique best, far from the start
+
+    StudentTable t;
+    if (!table_from_students(&t, aos, BENCH_STUDENTS)) {
+        fprintf(stderr, "Out of memory\n");
+        free(aos);
+        return;
+    }
+
+    // The id we search for is the last one: a full scan either way
+    int last_id = 100000 + BENCH_STUDENTS - 1;
+    double best[4] = {1e9, 1e9, 1e9, 1e9};
+    int ok = 1;
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+        clock_t c0 = clock();
+        Student *a = find_highest_gpa(aos, BENCH_STUDENTS);
+        clock_t c1 = clock();
+        int b = table_max_gpa(&t);
+        clock_t c2 = clock();
+        Student *c = find_by_id(aos, BENCH_STUDENTS, last_id);
+        clock_t c3 = clock();
+        int d = table_find_id(&t, last_id);
+        clock_t c4 = clock();
+
+        ok = ok && (a - aos) == b && (c - aos) == d;
+        clock_t ticks[4] = {c1 - c0, c2 - c1, c3 - c2, c4 - c3};
+        for (int k = 0; k < 4; k++) {
+            double ms = 1000.0 * (double)ticks[k] / CLOCKS_PER_SEC;
+            if (ms < best[k]) best[k] = ms;
+        }
+    }
+
+    printf("%-18s %10s %10s\n", "", "AoS", "SoA");
+    printf("%-18s %10.2f %10.2f\n", "max GPA", best[0], best[1]);
+    printf("%-18s %10.2f %10.2f\n", "find id", best[2], best[3]);
+    printf("Results %s.\n", ok ? "match" : "DIFFER");
+
+    table_free(&t);
+    free(aos);
+}
@@ -0,0 +1,515 @@
+/*
+ * Exercise 8.8: Fast Fourier Transform
+ *
+ * A direct DFT computes every output bin as a sum over every input sample:
+ *
+ *   X[k] = sum_j x[j] * e^(-2*pi*i*j*k/n)
+ *
+ * That is n complex multiplies per bin, n^2 in total - fine for 64 points,
+ * hopeless for a million. The FFT splits the sum into even and odd samples
+ * recursively, so the work drops to n*log2(n).
+ *
+ * This version is iterative rather than recursive:
+ *   1. Reorder the input into bit-reversed index order (0,4,2,6,1,5,3,7).
+ *   2. Run log2(n) butterfly stages in place, combining blocks of size
+ *      1, 2, 4, ... into blocks of size 2, 4, 8, ...
+ * Two stages are fused into one radix-4 pass over the data, so a 2^20
+ * point transform touches memory 10 times instead of 20.
+ *
+ * The twiddle factors e^(-2*pi*i*k/m) and the bit-reversal swaps depend
+ * only on n, so they are computed once in an FftPlan and reused for every
+ * transform of that size - the same idea as FFTW's plans.
+ *
+ * Python (NumPy) equivalent:
+ *   X = np.fft.fft(x)
+ *   x = np.fft.ifft(X)
+ *   X = np.fft.rfft(real_signal)   # n/2 + 1 bins
+ *
+ * Compile: cc -Wall -O2 -o ex08_fft ex08_fft.c ../common/fastfmt.c -lm
+ * Run: ./ex08_fft
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include "../common/fastfmt.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+typedef struct {
+    double real;
+    double imag;
+} Complex;
+
+// Index pairs to exchange for the bit-reversal permutation
+typedef struct {
+    uint32_t *pairs;  // [a0, b0, a1, b1, ...]
+    size_t count;
+} SwapTable;
+
+typedef struct {
+    size_t n;
+    // Twiddles stored stage by stage: the stage that joins blocks of
+    // size h reads twiddles[h - 1 .. 2h - 2] = e^(-2*pi*i*k/(2h)) for
+    // k < h, contiguously. The layout does not depend on n, so the
+    // table also serves the half-size transform inside fft_real.
+    Complex *twiddles;
+    SwapTable swaps;       // For size n
+    SwapTable half_swaps;  // For size n/2 (real-input transform)
+} FftPlan;
+
+// Function prototypes
+FftPlan *fft_plan_create(size_t n);
+void fft_plan_destroy(FftPlan *plan);
+void fft_forward(const FftPlan *plan, Complex *data);
+void fft_inverse(const FftPlan *plan, Complex *data);
+void fft_forward_batch(const FftPlan *plan, Complex *data, size_t count);
+void fft_inverse_batch(const FftPlan *plan, Complex *data, size_t count);
+void fft_real(const FftPlan *plan, const double *in, Complex *out);
+void dft_naive(const Complex *in, Complex *out, size_t n);
+
+Complex complex_add(Complex a, Complex b);
+Complex complex_subtract(Complex a, Complex b);
+Complex complex_multiply(Complex a, Complex b);
+void complex_print(Complex c);
+void benchmark(void);
+
+int main(void) {
+    // A small example: a cosine at frequency 1 plus a constant offset
+    const size_t n = 8;
+    Complex x[8];
+    for (size_t j = 0; j < n; j++) {
+        x[j].real = 1.0 + cos(2 * M_PI * j / n);
+        x[j].imag = 0.0;
+    }
+
+    FftPlan *plan = fft_plan_create(n);
+    if (plan == NULL) {
+        fprintf(stderr, "Failed to create FFT plan\n");
+        return 1;
+    }
+
+    printf("FFT of 1 + cos(2*pi*j/8):\n");
+    fft_forward(plan, x);
+    for (size_t k = 0; k < n; k++) {
+        printf("  X[%zu] = ", k);
+        complex_print(x[k]);
+    }
+
+    printf("Inverse FFT (round trip):\n");
+    fft_inverse(plan, x);
+    for (size_t j = 0; j < n; j++) {
+        printf("  x[%zu] = ", j);
+        complex_print(x[j]);
+    }
+
+    // Real-input transform returns only the n/2 + 1 non-redundant bins
+    double signal[8];
+    Complex spectrum[5];
+    for (size_t j = 0; j < n; j++) {
+        signal[j] = sin(2 * M_PI * 2 * j / n);
+    }
+    fft_real(plan, signal, spectrum);
+    printf("Real FFT of sin(2*pi*2j/8):\n");
+    for (size_t k = 0; k <= n / 2; k++) {
+        printf("  X[%zu] = ", k);
+        complex_print(spectrum[k]);
+    }
+
+    fft_plan_destroy(plan);
+
+    benchmark();
+    return 0;
+}
+
+// --- Complex helpers (from Exercise 8.2) ---
+
+Complex complex_add(Complex a, Complex b) {
+    Complex result = {a.real + b.real, a.imag + b.imag};
+    return result;
+}
+
+Complex complex_subtract(Complex a, Complex b) {
+    Complex result = {a.real - b.real, a.imag - b.imag};
+    return result;
+}
+
+Complex complex_multiply(Complex a, Complex b) {
+    Complex result = {a.real * b.real - a.imag * b.imag,
+                      a.real * b.imag + a.imag * b.real};
+    return result;
+}
+
+void complex_print(Complex c) {
+    // Print tiny rounding noise as zero
+    double re = fabs(c.real) < 1e-9 ? 0.0 : c.real;
+    double im = fabs(c.imag) < 1e-9 ? 0.0 : c.imag;
+    FmtSink out;
+    fmt_sink_init(&out, stdout);
+    fmt_fixed(&out, re, 3);
+    if (im >= 0) {
+        fmt_str(&out, " + ");
+        fmt_fixed(&out, im, 3);
+    } else {
+        fmt_str(&out, " - ");
+        fmt_fixed(&out, -im, 3);
+    }
+    fmt_str(&out, "i\n");
+    fmt_flush(&out);
+}
+
+// --- Plan ---
+
+static int is_power_of_two(size_t n) {
+    return n != 0 && (n & (n - 1)) == 0;
+}
+
+// Only pairs with i < rev(i) are stored, so each swap happens once
+static int swap_table_build(SwapTable *table, size_t n) {
+    table->count = 0;
+    table->pairs = malloc((n + 1) * sizeof(uint32_t));
+    if (table->pairs == NULL) {
+        return 0;
+    }
+    int bits = 0;
+    while (((size_t)1 << bits) < n) {
+        bits++;
+    }
+    for (size_t i = 0; i < n; i++) {
+        size_t rev = 0;
+        for (int b = 0; b < bits; b++) {
+            rev |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        if (i < rev) {
+            table->pairs[2 * table->count] = (uint32_t)i;
+            table->pairs[2 * table->count + 1] = (uint32_t)rev;
+            table->count++;
+        }
+    }
+    return 1;
+}
+
+// Returns NULL if n is not a power of two (up to 2^31) or on allocation failure
+FftPlan *fft_plan_create(size_t n) {
+    if (!is_power_of_two(n) || n > ((size_t)1 << 31)) {
+        return NULL;
+    }
+    FftPlan *plan = calloc(1, sizeof(FftPlan));
+    if (plan == NULL) {
+        return NULL;
+    }
+    plan->n = n;
+    // Stages h = 1, 2, ..., n/2 need 1 + 2 + ... + n/2 = n - 1 twiddles
+    plan->twiddles = malloc(n * sizeof(Complex));
+    if (plan->twiddles == NULL
+        || !swap_table_build(&plan->swaps, n)
+        || !swap_table_build(&plan->half_swaps, n > 1 ? n / 2 : 1)) {
+        fft_plan_destroy(plan);
+        return NULL;
+    }
+    for (size_t h = 1; h < n; h *= 2) {
+        Complex *tw = plan->twiddles + h - 1;
+        for (size_t k = 0; k < h; k++) {
+            double angle = -M_PI * (double)k / (double)h;
+            tw[k].real = cos(angle);
+            tw[k].imag = sin(angle);
+        }
+    }
+    return plan;
+}
+
+void fft_plan_destroy(FftPlan *plan) {
+    if (plan == NULL) {
+        return;
+    }
+    free(plan->twiddles);
+    free(plan->swaps.pairs);
+    free(plan->half_swaps.pairs);
+    free(plan);
+}
+
+// --- Transform core ---
+
+static void bit_reverse(const SwapTable *table, Complex *data) {
+    for (size_t s = 0; s < table->count; s++) {
+        uint32_t a = table->pairs[2 * s];
+        uint32_t b = table->pairs[2 * s + 1];
+        Complex tmp = data[a];
+        data[a] = data[b];
+        data[b] = tmp;
+    }
+}
+
+// In-place forward transform of n points (n a power of two). The
+// twiddle table must cover stages up to n/2.
+static void fft_core(const Complex *twiddles, const SwapTable *swaps, Complex *data, size_t n) {
+    bit_reverse(swaps, data);
+
+    size_t h = 1;
+
+    // With an odd number of stages, do one plain radix-2 stage first
+    // (h = 1 has a single twiddle of 1, so it is just add/subtract)
+    int stages = 0;
+    while (((size_t)1 << stages) < n) {
+        stages++;
+    }
+    if (stages % 2 == 1) {
+        for (size_t s = 0; s < n; s += 2) {
+            Complex a = data[s], b = data[s + 1];
+            data[s] = complex_add(a, b);
+            data[s + 1] = complex_subtract(a, b);
+        }
+        h = 2;
+    }
+
+    // Radix-4 passes: each fuses stage h (blocks of 2h) with stage 2h
+    // (blocks of 4h). For one butterfly with w1 = W(2h)^k, w2 = W(4h)^k:
+    //   b0 = a0 + w1*a1    b1 = a0 - w1*a1
+    //   b2 = a2 + w1*a3    b3 = a2 - w1*a3
+    //   y0 = b0 + w2*b2    y2 = b0 - w2*b2
+    //   y1 = b1 - i*w2*b3  y3 = b1 + i*w2*b3     (W(4h)^(k+h) = -i*W(4h)^k)
+    for (; h < n; h *= 4) {
+        const Complex *tw1 = twiddles + h - 1;
+        const Complex *tw2 = twiddles + 2 * h - 1;
+        for (size_t s = 0; s < n; s += 4 * h) {
+            Complex *p = data + s;
+            for (size_t k = 0; k < h; k++) {
+                Complex w1 = tw1[k];
+                Complex w2 = tw2[k];
+
+                Complex a0 = p[k];
+                Complex a1 = complex_multiply(w1, p[k + h]);
+                Complex a2 = p[k + 2 * h];
+                Complex a3 = complex_multiply(w1, p[k + 3 * h]);
+
+                Complex b0 = complex_add(a0, a1);
+                Complex b1 = complex_subtract(a0, a1);
+                Complex b2 = complex_multiply(w2, complex_add(a2, a3));
+                Complex b3 = complex_multiply(w2, complex_subtract(a2, a3));
+
+                // -i * (x + yi) = y - xi
+                Complex b3_rot = {b3.imag, -b3.real};
+
+                p[k] = complex_add(b0, b2);
+                p[k + 2 * h] = complex_subtract(b0, b2);
+                p[k + h] = complex_add(b1, b3_rot);
+                p[k + 3 * h] = complex_subtract(b1, b3_rot);
+            }
+        }
+    }
+}
+
+void fft_forward(const FftPlan *plan, Complex *data) {
+    fft_core(plan->twiddles, &plan->swaps, data, plan->n);
+}
+
+// ifft(X) = conj(fft(conj(X))) / n
+void fft_inverse(const FftPlan *plan, Complex *data) {
+    size_t n = plan->n;
+    for (size_t i = 0; i < n; i++) {
+        data[i].imag = -data[i].imag;
+    }
+    fft_core(plan->twiddles, &plan->swaps, data, n);
+    double scale = 1.0 / (double)n;
+    for (size_t i = 0; i < n; i++) {
+        data[i].real *= scale;
+        data[i].imag *= -scale;
+    }
+}
+
+// count transforms of plan->n points stored back to back. The plan's
+// tables stay in cache across the whole batch.
+void fft_forward_batch(const FftPlan *plan, Complex *data, size_t count) {
+    for (size_t b = 0; b < count; b++) {
+        fft_forward(plan, data + b * plan->n);
+    }
+}
+
+void fft_inverse_batch(const FftPlan *plan, Complex *data, size_t count) {
+    for (size_t b = 0; b < count; b++) {
+        fft_inverse(plan, data + b * plan->n);
+    }
+}
+
+// Transform n real samples into the n/2 + 1 bins X[0..n/2] (the rest are
+// conjugates of these). The samples are packed as n/2 complex values
+// z[j] = x[2j] + i*x[2j+1], transformed at half size, then separated:
+//   E[k] = (Z[k] + conj(Z[n/2-k])) / 2        (spectrum of even samples)
+//   O[k] = (Z[k] - conj(Z[n/2-k])) / 2i       (spectrum of odd samples)
+//   X[k] = E[k] + W(n)^k * O[k]
+// out must hold n/2 + 1 values and is also used as the work buffer.
+void fft_real(const FftPlan *plan, const double *in, Complex *out) {
+    size_t n = plan->n;
+    if (n == 1) {
+        out[0].real = in[0];
+        out[0].imag = 0.0;
+        return;
+    }
+    size_t half = n / 2;
+    for (size_t j = 0; j < half; j++) {
+        out[j].real = in[2 * j];
+        out[j].imag = in[2 * j + 1];
+    }
+    fft_core(plan->twiddles, &plan->half_swaps, out, half);
+
+    // W(n)^k for k < n/2 is the last stage of the twiddle table
+    const Complex *tw = plan->twiddles + half - 1;
+    Complex z0 = out[0];
+    out[0].real = z0.real + z0.imag;
+    out[0].imag = 0.0;
+    out[half].real = z0.real - z0.imag;
+    out[half].imag = 0.0;
+
+    // Bins k and n/2-k use each other's values, so process them in pairs
+    for (size_t k = 1; k <= half / 2; k++) {
+        size_t m = half - k;
+        Complex zk = out[k], zm = out[m];
+        Complex results[2];
+        for (int side = 0; side < 2; side++) {
+            Complex a = side == 0 ? zk : zm;
+            Complex b = side == 0 ? zm : zk;
+            size_t idx = side == 0 ? k : m;
+            Complex e = {(a.real + b.real) * 0.5, (a.imag - b.imag) * 0.5};
+            // (a - conj(b)) / 2i
+            Complex o = {(a.imag + b.imag) * 0.5, -(a.real - b.real) * 0.5};
+            results[side] = complex_add(e, complex_multiply(tw[idx], o));
+        }
+        out[k] = results[0];
+        out[m] = results[1];
+    }
+}
+
+// The O(n^2) definition, kept as a reference for checking results
+void dft_naive(const Complex *in, Complex *out, size_t n) {
+    for (size_t k = 0; k < n; k++) {
+        Complex sum = {0.0, 0.0};
+        for (size_t j = 0; j < n; j++) {
+            double angle = -2 * M_PI * (double)((j * k) % n) / (double)n;
+            Complex w = {cos(angle), sin(angle)};
+            sum = complex_add(sum, complex_multiply(in[j], w));
+        }
+        out[k] = sum;
+    }
+}
+
+// --- Benchmark ---
+
+static double max_error(const Complex *a, const Complex *b, size_t n) {
+    double worst = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double err = hypot(a[i].real - b[i].real, a[i].imag - b[i].imag);
+        if (err > worst) worst = err;
+    }
+    return worst;
+}
+
+static double elapsed(clock_t start, clock_t end) {
+    return (double)(end - start) / CLOCKS_PER_SEC;
+}
+
+void benchmark(void) {
+    printf("\n=== Benchmark ===\n");
+    srand(8);
+
+    // FFT against the direct DFT, including accuracy
+    printf("%8s %12s %12s %10s\n", "n", "DFT (ms)", "FFT (ms)", "max err");
+    for (size_t n = 256; n <= 4096; n *= 4) {
+        Complex *x = malloc(n * sizeof(Complex));
+        Complex *ref = malloc(n * sizeof(Complex));
+        FftPlan *plan = fft_plan_create(n);
+        if (x == NULL || ref == NULL || plan == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            free(x);
+            free(ref);
+            fft_plan_destroy(plan);
+            return;
+        }
+        for (size_t i = 0; i < n; i++) {
+            x[i].real = rand() / (double)RAND_MAX - 0.5;
+            x[i].imag = rand() / (double)RAND_MAX - 0.5;
+        }
+        clock_t start = clock();
+        dft_naive(x, ref, n);
+        clock_t mid = clock();
+        fft_forward(plan, x);
+        clock_t end = clock();
+        printf("%8zu %12.3f %12.3f %10.2e\n", n, elapsed(start, mid) * 1e3,
+               elapsed(mid, end) * 1e3, max_error(x, ref, n));
+        free(x);
+        free(ref);
+        fft_plan_destroy(plan);
+    }
+
+    // Large transforms: complex forward, and real input of the same length
+    printf("\n%8s %14s %14s %14s\n", "n", "complex (ms)", "real (ms)", "round trip err");
+    for (size_t n = (size_t)1 << 12; n <= ((size_t)1 << 20); n <<= 4) {
+        Complex *x = malloc(n * sizeof(Complex));
+        Complex *orig = malloc(n * sizeof(Complex));
+        double *r = malloc(n * sizeof(double));
+        Complex *spec = malloc((n / 2 + 1) * sizeof(Complex));
+        FftPlan *plan = fft_plan_create(n);
+        if (x == NULL || orig == NULL || r == NULL || spec == NULL || plan == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            free(x);
+            free(orig);
+            free(r);
+            free(spec);
+            fft_plan_destroy(plan);
+            return;
+        }
+        for (size_t i = 0; i < n; i++) {
+            r[i] = rand() / (double)RAND_MAX - 0.5;
+            orig[i].real = r[i];
+            orig[i].imag = 0.0;
+            x[i] = orig[i];
+        }
+        clock_t start = clock();
+        fft_forward(plan, x);
+        clock_t mid = clock();
+        fft_real(plan, r, spec);
+        clock_t end = clock();
+
+        // The real transform must agree with the first half of the full one
+        double spec_err = max_error(spec, x, n / 2 + 1);
+        fft_inverse(plan, x);
+        printf("%8zu %14.3f %14.3f %14.2e\n", n, elapsed(start, mid) * 1e3,
+               elapsed(mid, end) * 1e3, max_error(x, orig, n));
+        if (spec_err > 1e-6) {
+            printf("  real FFT mismatch: %.2e\n", spec_err);
+        }
+        free(x);
+        free(orig);
+        free(r);
+        free(spec);
+        fft_plan_destroy(plan);
+    }
+
+    // Many small transforms sharing one plan
+    const size_t batch_n = 1024, batch_count = 4096;
+    Complex *batch = malloc(batch_n * batch_count * sizeof(Complex));
+    FftPlan *plan = fft_plan_create(batch_n);
+    if (batch == NULL || plan == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        free(batch);
+        fft_plan_destroy(plan);
+        return;
+    }
+    for (size_t i = 0; i < batch_n * batch_count; i++) {
+        batch[i].real = rand() / (double)RAND_MAX - 0.5;
+        batch[i].imag = 0.0;
+    }
+    clock_t start = clock();
+    fft_forward_batch(plan, batch, batch_count);
+    clock_t end = clock();
+    double seconds = elapsed(start, end);
+    printf("\nBatch: %zu x %zu-point FFTs in %.3f ms (%.0f transforms/s)\n",
+           batch_count, batch_n, seconds * 1e3,
+           seconds > 0 ? batch_count / seconds : 0.0);
+    fft_inverse_batch(plan, batch, batch_count);
+    free(batch);
+    fft_plan_destroy(plan);
+}
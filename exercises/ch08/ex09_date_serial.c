@@ -0,0 +1,443 @@
+/*
+ * Exercise 8.9: Serial Day Numbers
+ *
+ * Exercise 8.3 stores a Date as three ints. Comparing two dates means
+ * comparing year, then month, then day; finding the days between them
+ * means walking through months with days_in_month. Both branch a lot.
+ *
+ * Storing a date as a single integer - days since 1970-01-01 - turns
+ * all of that into plain integer arithmetic:
+ *
+ *   compare   ->  a - b
+ *   diff      ->  b - a
+ *   add days  ->  a + n
+ *   sort      ->  sort ints (here: a radix sort)
+ *
+ * The conversions use Howard Hinnant's civil-calendar algorithms. They
+ * shift the year to start in March, so the leap day is the last day of
+ * the year, and then count 400-year eras (146097 days each). There are
+ * no loops and no per-month tables; the ternaries compile to
+ * conditional moves.
+ *
+ * Python equivalent:
+ *   from datetime import date, timedelta
+ *   serial = (d - date(1970, 1, 1)).days
+ *   d = date(1970, 1, 1) + timedelta(days=serial)
+ *   (b - a).days
+ *
+ * Compile: cc -Wall -O2 -o ex09_date_serial ex09_date_serial.c ../common/fastfmt.c
+ * Run: ./ex09_date_serial
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "../common/fastfmt.h"
+
+#define BENCH_COUNT 10000000
+
+typedef struct {
+    int year;
+    int month;
+    int day;
+} Date;
+
+// Days since 1970-01-01 (negative before it). int32 covers +/- 5.8 million years.
+typedef int32_t DaySerial;
+
+// Function prototypes
+Date date_create(int year, int month, int day);
+int is_leap_year(int year);
+int days_in_month(int year, int month);
+int is_valid_date(Date d);
+
+DaySerial date_to_days(Date d);
+Date days_to_date(DaySerial days);
+int days_compare(DaySerial a, DaySerial b);  // Returns -1, 0, or 1
+int32_t days_diff(DaySerial from, DaySerial to);
+DaySerial days_add(DaySerial days, int32_t n);
+int days_weekday(DaySerial days);  // 0 = Sunday ... 6 = Saturday
+DaySerial days_from_unix_seconds(int64_t seconds);
+
+void dates_to_days(const Date *dates, DaySerial *out, size_t n);
+void days_to_dates(const DaySerial *days, Date *out, size_t n);
+void days_add_batch(DaySerial *days, size_t n, int32_t offset);
+void days_diff_batch(const DaySerial *from, const DaySerial *to, int32_t *out, size_t n);
+void days_from_unix_seconds_batch(const int64_t *seconds, DaySerial *out, size_t n);
+int days_sort(DaySerial *days, size_t n);
+
+int compare_dates(Date a, Date b);
+void print_date(Date d);
+void benchmark(void);
+
+int main(void) {
+    printf("=== Serial Day Numbers ===\n");
+    Date samples[] = {
+        date_create(1970, 1, 1),
+        date_create(2000, 2, 29),
+        date_create(2024, 6, 15),
+        date_create(1969, 12, 31),
+        date_create(1, 1, 1),
+        date_create(9999, 12, 31),
+    };
+    int count = sizeof(samples) / sizeof(samples[0]);
+    for (int i = 0; i < count; i++) {
+        DaySerial s = date_to_days(samples[i]);
+        print_date(samples[i]);
+        printf(" -> %8d -> ", s);
+        print_date(days_to_date(s));
+        printf("\n");
+    }
+
+    printf("\n=== Arithmetic ===\n");
+    DaySerial a = date_to_days(date_create(2024, 6, 15));
+    DaySerial b = date_to_days(date_create(2025, 3, 1));
+    print_date(days_to_date(a));
+    printf(" vs ");
+    print_date(days_to_date(b));
+    printf(" : compare %d, %d days apart\n", days_compare(a, b), days_diff(a, b));
+
+    print_date(days_to_date(a));
+    printf(" + 100 days = ");
+    print_date(days_to_date(days_add(a, 100)));
+    printf("\n");
+
+    const char *weekdays[] = {"Sunday", "Monday", "Tuesday", "Wednesday",
+                              "Thursday", "Friday", "Saturday"};
+    print_date(days_to_date(a));
+    printf(" is a %s\n", weekdays[days_weekday(a)]);
+
+    printf("\n=== Validation ===\n");
+    Date checks[] = {
+        date_create(2024, 2, 29),
+        date_create(2023, 2, 29),
+        date_create(2024, 4, 31),
+        date_create(2024, 13, 1),
+    };
+    for (int i = 0; i < 4; i++) {
+        print_date(checks[i]);
+        printf(" - %s\n", is_valid_date(checks[i]) ? "Valid" : "Invalid");
+    }
+
+    benchmark();
+    return 0;
+}
+
+// --- Field-based helpers (from Exercise 8.3) ---
+
+Date date_create(int year, int month, int day) {
+    Date d = {year, month, day};
+    return d;
+}
+
+int is_leap_year(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+int days_in_month(int year, int month) {
+    static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month < 1 || month > 12) {
+        return 0;
+    }
+    return days[month - 1] + (month == 2 && is_leap_year(year));
+}
+
+int is_valid_date(Date d) {
+    return d.year > 0 && d.day >= 1 && d.day <= days_in_month(d.year, d.month);
+}
+
+int compare_dates(Date a, Date b) {
+    if (a.year != b.year) return a.year < b.year ? -1 : 1;
+    if (a.month != b.month) return a.month < b.month ? -1 : 1;
+    if (a.day != b.day) return a.day < b.day ? -1 : 1;
+    return 0;
+}
+
+void print_date(Date d) {
+    FmtSink out;
+    fmt_sink_init(&out, stdout);
+    fmt_i64_zero_pad(&out, d.year, 4);
+    fmt_char(&out, '-');
+    fmt_i64_zero_pad(&out, d.month, 2);
+    fmt_char(&out, '-');
+    fmt_i64_zero_pad(&out, d.day, 2);
+    fmt_flush(&out);
+}
+
+// --- Serial conversions ---
+
+// d must be a valid date (see is_valid_date)
+DaySerial date_to_days(Date d) {
+    // Treat January and February as months 11 and 12 of the previous year
+    int y = d.year - (d.month <= 2);
+    // Floor division by 400 for negative years too
+    int era = (y >= 0 ? y : y - 399) / 400;
+    int yoe = y - era * 400;                                         // [0, 399]
+    int mp = d.month + (d.month > 2 ? -3 : 9);                       // Mar = 0
+    int doy = (153 * mp + 2) / 5 + d.day - 1;                        // [0, 365]
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;                 // [0, 146096]
+    return era * 146097 + doe - 719468;  // 719468 = days from 0000-03-01 to 1970-01-01
+}
+
+Date days_to_date(DaySerial days) {
+    int z = days + 719468;
+    int era = (z >= 0 ? z : z - 146096) / 146097;
+    int doe = z - era * 146097;                                      // [0, 146096]
+    int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365; // [0, 399]
+    int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);               // [0, 365]
+    int mp = (5 * doy + 2) / 153;                                    // [0, 11]
+    Date d;
+    d.day = doy - (153 * mp + 2) / 5 + 1;
+    d.month = mp + (mp < 10 ? 3 : -9);
+    d.year = yoe + era * 400 + (d.month <= 2);
+    return d;
+}
+
+int days_compare(DaySerial a, DaySerial b) {
+    return (a > b) - (a < b);
+}
+
+int32_t days_diff(DaySerial from, DaySerial to) {
+    return to - from;
+}
+
+DaySerial days_add(DaySerial days, int32_t n) {
+    return days + n;
+}
+
+int days_weekday(DaySerial days) {
+    // 1970-01-01 was a Thursday (4); keep the result non-negative
+    int w = (days + 4) % 7;
+    return w < 0 ? w + 7 : w;
+}
+
+DaySerial days_from_unix_seconds(int64_t seconds) {
+    // Floor division, so 1969-12-31T23:59:59 is day -1, not day 0
+    int64_t q = seconds / 86400;
+    return (DaySerial)(q - (seconds % 86400 < 0));
+}
+
+// --- Batch versions ---
+// Simple loops over arrays with no cross-iteration dependencies, so the
+// compiler is free to unroll and vectorize them.
+
+void dates_to_days(const Date *dates, DaySerial *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = date_to_days(dates[i]);
+    }
+}
+
+void days_to_dates(const DaySerial *days, Date *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = days_to_date(days[i]);
+    }
+}
+
+void days_add_batch(DaySerial *days, size_t n, int32_t offset) {
+    for (size_t i = 0; i < n; i++) {
+        days[i] += offset;
+    }
+}
+
+void days_diff_batch(const DaySerial *from, const DaySerial *to, int32_t *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = to[i] - from[i];
+    }
+}
+
+void days_from_unix_seconds_batch(const int64_t *seconds, DaySerial *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = days_from_unix_seconds(seconds[i]);
+    }
+}
+
+// LSD radix sort, two passes of 16 bits. Flipping the sign bit maps
+// signed order onto unsigned order. Returns 0 on allocation failure.
+int days_sort(DaySerial *days, size_t n) {
+    uint32_t *keys = malloc(n * sizeof(uint32_t));
+    uint32_t *tmp = malloc(n * sizeof(uint32_t));
+    size_t *counts = calloc(2 * 65536, sizeof(size_t));
+    if (keys == NULL || tmp == NULL || counts == NULL) {
+        free(keys);
+        free(tmp);
+        free(counts);
+        return 0;
+    }
+
+    // One pass to build both histograms
+    for (size_t i = 0; i < n; i++) {
+        keys[i] = (uint32_t)days[i] ^ 0x80000000u;
+        counts[keys[i] & 0xFFFF]++;
+        counts[65536 + (keys[i] >> 16)]++;
+    }
+
+    uint32_t *src = keys, *dst = tmp;
+    for (int pass = 0; pass < 2; pass++) {
+        size_t *count = counts + pass * 65536;
+        int shift = pass * 16;
+        size_t total = 0;
+        for (size_t b = 0; b < 65536; b++) {
+            size_t c = count[b];
+            count[b] = total;
+            total += c;
+        }
+        for (size_t i = 0; i < n; i++) {
+            dst[count[(src[i] >> shift) & 0xFFFF]++] = src[i];
+        }
+        uint32_t *swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        days[i] = (DaySerial)(src[i] ^ 0x80000000u);
+    }
+    free(keys);
+    free(tmp);
+    free(counts);
+    return 1;
+}
+
+// --- Benchmark ---
+
+// The field-based way: count whole years, then months, then days
+static int32_t diff_by_fields(Date a, Date b) {
+    int sign = 1;
+    if (compare_dates(a, b) > 0) {
+        Date t = a;
+        a = b;
+        b = t;
+        sign = -1;
+    }
+    int32_t total = 0;
+    for (int y = a.year; y < b.year; y++) {
+        total += is_leap_year(y) ? 366 : 365;
+    }
+    for (int m = 1; m < b.month; m++) {
+        total += days_in_month(b.year, m);
+    }
+    for (int m = 1; m < a.month; m++) {
+        total -= days_in_month(a.year, m);
+    }
+    total += b.day - a.day;
+    return sign * total;
+}
+
+static int compare_date_ptrs(const void *a, const void *b) {
+    return compare_dates(*(const Date *)a, *(const Date *)b);
+}
+
+static double elapsed_ms(clock_t start, clock_t end) {
+    return (double)(end - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+void benchmark(void) {
+    size_t n = BENCH_COUNT;
+    Date *dates = malloc(n * sizeof(Date));
+    Date *back = malloc(n * sizeof(Date));
+    DaySerial *days = malloc(n * sizeof(DaySerial));
+    DaySerial *later = malloc(n * sizeof(DaySerial));
+    int32_t *diffs = malloc(n * sizeof(int32_t));
+    if (dates == NULL || back == NULL || days == NULL || later == NULL || diffs == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        goto done;
+    }
+
+    // Exhaustive round trip over 0001-01-01 .. 9999-12-31
+    DaySerial first = date_to_days(date_create(1, 1, 1));
+    DaySerial last = date_to_days(date_create(9999, 12, 31));
+    Date expect = date_create(1, 1, 1);
+    int mismatches = 0;
+    for (DaySerial s = first; s <= last; s++) {
+        Date d = days_to_date(s);
+        if (compare_dates(d, expect) != 0 || date_to_days(d) != s) {
+            mismatches++;
+        }
+        // Step the expected date forward the slow way
+        if (++expect.day > days_in_month(expect.year, expect.month)) {
+            expect.day = 1;
+            if (++expect.month > 12) {
+                expect.month = 1;
+                expect.year++;
+            }
+        }
+    }
+    printf("\nRound trip over %d days: %d mismatches\n", last - first + 1, mismatches);
+
+    // Random dates between 1900 and 2100
+    srand(37);
+    DaySerial lo = date_to_days(date_create(1900, 1, 1));
+    DaySerial span = date_to_days(date_create(2100, 1, 1)) - lo;
+    for (size_t i = 0; i < n; i++) {
+        dates[i] = days_to_date(lo + (DaySerial)(((uint32_t)rand() << 8 ^ (uint32_t)rand()) % (uint32_t)span));
+    }
+
+    printf("\n=== Benchmark: %d dates ===\n", BENCH_COUNT);
+    clock_t start, end;
+
+    start = clock();
+    dates_to_days(dates, days, n);
+    end = clock();
+    printf("%-32s %8.1f ms\n", "Date -> serial", elapsed_ms(start, end));
+
+    start = clock();
+    days_to_dates(days, back, n);
+    end = clock();
+    printf("%-32s %8.1f ms\n", "serial -> Date", elapsed_ms(start, end));
+
+    // Differences between each date and the next one in the array
+    start = clock();
+    int64_t field_sum = 0;
+    for (size_t i = 0; i + 1 < n; i++) {
+        field_sum += diff_by_fields(dates[i], dates[i + 1]);
+    }
+    end = clock();
+    printf("%-32s %8.1f ms\n", "diff via fields", elapsed_ms(start, end));
+
+    start = clock();
+    days_diff_batch(days, days + 1, diffs, n - 1);
+    end = clock();
+    int64_t serial_sum = 0;
+    for (size_t i = 0; i + 1 < n; i++) {
+        serial_sum += diffs[i];
+    }
+    printf("%-32s %8.1f ms%s\n", "diff via serials (batch)", elapsed_ms(start, end),
+           serial_sum == field_sum ? "" : "  MISMATCH");
+
+    memcpy(later, days, n * sizeof(DaySerial));
+    start = clock();
+    days_add_batch(later, n, 30);
+    end = clock();
+    printf("%-32s %8.1f ms\n", "add 30 days (batch)", elapsed_ms(start, end));
+
+    // Sorting: qsort with the field comparison vs radix sort on serials
+    start = clock();
+    qsort(back, n, sizeof(Date), compare_date_ptrs);
+    end = clock();
+    printf("%-32s %8.1f ms\n", "qsort(Date, compare_dates)", elapsed_ms(start, end));
+
+    start = clock();
+    if (!days_sort(days, n)) {
+        fprintf(stderr, "Out of memory\n");
+        goto done;
+    }
+    end = clock();
+    int sorted_ok = 1;
+    for (size_t i = 0; i < n; i++) {
+        if (date_to_days(back[i]) != days[i]) {
+            sorted_ok = 0;
+            break;
+        }
+    }
+    printf("%-32s %8.1f ms%s\n", "radix sort serials", elapsed_ms(start, end),
+           sorted_ok ? "" : "  MISMATCH");
+
+done:
+    free(dates);
+    free(back);
+    free(days);
+    free(later);
+    free(diffs);
+}
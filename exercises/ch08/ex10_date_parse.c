@@ -0,0 +1,403 @@
+/*
+ * Exercise 8.10: Batch Date Parsing
+ *
+ * Turn many "YYYY-MM-DD" strings into Date values and validate them in
+ * one pass. A bad entry does not stop the batch: each element gets a bit
+ * in an "invalid" bitmask and the caller decides what to do with it.
+ *
+ * Python equivalent:
+ *   out, invalid = [], []
+ *   for i, s in enumerate(strings):
+ *       try:
+ *           out.append(date.fromisoformat(s))
+ *       except ValueError:
+ *           out.append(None); invalid.append(i)
+ *
+ * With SSSE3 available, one 16-byte register holds a whole date string:
+ *   - Format check: every byte must lie between "0000-00-00" and
+ *     "9999-99-99" position by position - two packed compares.
+ *   - Digits: subtract '0', shuffle the eight digits together (pshufb)
+ *     and multiply-add neighbouring pairs (pmaddubsw) to get the
+ *     two-digit values 20|24|06|15 in one instruction.
+ * Calendar checks then use lookup tables built from is_leap_year and
+ * days_in_month (same rules as Exercise 8.3), with no per-field branches.
+ *
+ * Compile: cc -Wall -O2 -march=native -o ex10_date_parse ex10_date_parse.c ../common/fastfmt.c
+ * Run: ./ex10_date_parse
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "../common/fastfmt.h"
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+#define DATE_LEN 10
+#define MAX_YEAR 9999
+#define BENCH_COUNT 10000000
+#define BENCH_RUNS 3
+
+typedef struct {
+    int year;
+    int month;
+    int day;
+} Date;
+
+// Function prototypes
+int is_leap_year(int year);
+int days_in_month(int year, int month);
+int is_valid_date(Date d);
+void print_date(Date d);
+
+int parse_date(const char *s, size_t len, Date *out);
+size_t parse_dates(const char *const *strings, size_t n, Date *out, uint64_t *invalid);
+size_t parse_dates_fixed(const char *buf, size_t stride, size_t n, Date *out, uint64_t *invalid);
+int date_is_invalid(const uint64_t *invalid, size_t i);
+void benchmark(void);
+
+int main(void) {
+    const char *inputs[] = {
+        "2024-01-15",
+        "2024-02-29",   // Leap year
+        "2023-02-29",   // Not a leap year
+        "2024-04-31",   // April has 30 days
+        "2024-13-01",   // No month 13
+        "0000-06-01",   // Year must be > 0
+        "2024-1-05",    // Wrong length
+        "20x4-01-05",   // Not a digit
+        "2024/01/05",   // Wrong separator
+        "1900-02-29",   // Century, not divisible by 400
+        "2000-02-29",   // Divisible by 400
+        "9999-12-31",
+    };
+    size_t n = sizeof(inputs) / sizeof(inputs[0]);
+
+    Date dates[12];
+    uint64_t invalid[1];
+    size_t valid = parse_dates(inputs, n, dates, invalid);
+
+    printf("=== Batch Parse ===\n");
+    for (size_t i = 0; i < n; i++) {
+        printf("%-12s -> ", inputs[i]);
+        if (date_is_invalid(invalid, i)) {
+            printf("invalid\n");
+        } else {
+            print_date(dates[i]);
+            printf("\n");
+        }
+    }
+    printf("%zu of %zu valid, invalid mask = 0x%03llx\n",
+           valid, n, (unsigned long long)invalid[0]);
+
+    benchmark();
+    return 0;
+}
+
+// --- Calendar rules (from Exercise 8.3) ---
+
+int is_leap_year(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+int days_in_month(int year, int month) {
+    static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month < 1 || month > 12) {
+        return 0;
+    }
+    return days[month - 1] + (month == 2 && is_leap_year(year));
+}
+
+int is_valid_date(Date d) {
+    return d.year > 0 && d.day >= 1 && d.day <= days_in_month(d.year, d.month);
+}
+
+void print_date(Date d) {
+    FmtSink out;
+    fmt_sink_init(&out, stdout);
+    fmt_i64_zero_pad(&out, d.year, 4);
+    fmt_char(&out, '-');
+    fmt_i64_zero_pad(&out, d.month, 2);
+    fmt_char(&out, '-');
+    fmt_i64_zero_pad(&out, d.day, 2);
+    fmt_flush(&out);
+}
+
+// --- Lookup tables ---
+
+// month_length[leap][month] for month 0..99 (two parsed digits); 0 means
+// "no such month", so any day fails the check
+static uint8_t month_length[2][100];
+// One bit per year 0..9999; year 0 is left clear and rejected separately
+static uint8_t leap_bits[(MAX_YEAR + 8) / 8];
+static int tables_ready = 0;
+
+static void init_tables(void) {
+    if (tables_ready) {
+        return;
+    }
+    for (int m = 1; m <= 12; m++) {
+        month_length[0][m] = (uint8_t)days_in_month(2023, m);
+        month_length[1][m] = (uint8_t)days_in_month(2024, m);
+    }
+    for (int y = 1; y <= MAX_YEAR; y++) {
+        if (is_leap_year(y)) {
+            leap_bits[y >> 3] |= (uint8_t)(1u << (y & 7));
+        }
+    }
+    tables_ready = 1;
+}
+
+// Equivalent to is_valid_date for years 0..9999, months/days 0..99
+static inline int fields_valid(int year, int month, int day) {
+    int leap = (leap_bits[year >> 3] >> (year & 7)) & 1;
+    int max_day = month_length[leap][month];
+    // Unsigned trick: (day - 1) < max_day checks 1 <= day <= max_day
+    return (year != 0) & ((unsigned)(day - 1) < (unsigned)max_day);
+}
+
+static inline void mark(uint64_t *invalid, size_t i, int bad) {
+    invalid[i / 64] |= (uint64_t)bad << (i % 64);
+}
+
+int date_is_invalid(const uint64_t *invalid, size_t i) {
+    return (int)((invalid[i / 64] >> (i % 64)) & 1);
+}
+
+// --- Scalar parser ---
+
+// Parse exactly "YYYY-MM-DD". Returns 1 and fills *out if the text is
+// well formed and the date exists, otherwise returns 0.
+int parse_date(const char *s, size_t len, Date *out) {
+    init_tables();
+    if (len != DATE_LEN || s[4] != '-' || s[7] != '-') {
+        return 0;
+    }
+    static const int digit_pos[] = {0, 1, 2, 3, 5, 6, 8, 9};
+    int v[8];
+    for (int i = 0; i < 8; i++) {
+        unsigned d = (unsigned char)s[digit_pos[i]] - '0';
+        if (d > 9) {
+            return 0;
+        }
+        v[i] = (int)d;
+    }
+    int year = v[0] * 1000 + v[1] * 100 + v[2] * 10 + v[3];
+    int month = v[4] * 10 + v[5];
+    int day = v[6] * 10 + v[7];
+    if (!fields_valid(year, month, day)) {
+        return 0;
+    }
+    out->year = year;
+    out->month = month;
+    out->day = day;
+    return 1;
+}
+
+// --- SIMD parser ---
+
+// s points at 16 readable bytes; only the first DATE_LEN are used
+static inline int parse_date16(const char *s, Date *out) {
+#ifdef __SSSE3__
+    const __m128i lo = _mm_setr_epi8('0', '0', '0', '0', '-', '0', '0', '-', '0', '0',
+                                     0, 0, 0, 0, 0, 0);
+    const __m128i hi = _mm_setr_epi8('9', '9', '9', '9', '-', '9', '9', '-', '9', '9',
+                                     -1, -1, -1, -1, -1, -1);
+    __m128i v = _mm_loadu_si128((const __m128i *)s);
+
+    // lo <= v <= hi in every byte (unsigned); bytes 10..15 always pass
+    __m128i in_range = _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(v, lo), v),
+                                     _mm_cmpeq_epi8(_mm_min_epu8(v, hi), v));
+    int format_ok = _mm_movemask_epi8(in_range) == 0xFFFF;
+
+    // Gather the digits: Y Y Y Y M M D D, then pair them up as 10*a + b
+    const __m128i gather = _mm_setr_epi8(0, 1, 2, 3, 5, 6, 8, 9,
+                                         -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i tens = _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1,
+                                       0, 0, 0, 0, 0, 0, 0, 0);
+    __m128i digits = _mm_shuffle_epi8(_mm_sub_epi8(v, _mm_set1_epi8('0')), gather);
+    __m128i pairs = _mm_maddubs_epi16(digits, tens);
+
+    int year = _mm_extract_epi16(pairs, 0) * 100 + _mm_extract_epi16(pairs, 1);
+    int month = _mm_extract_epi16(pairs, 2);
+    int day = _mm_extract_epi16(pairs, 3);
+
+    // On bad input the digit values are garbage; zero them so the table
+    // lookups stay in bounds
+    year &= -format_ok;
+    month &= -format_ok;
+    day &= -format_ok;
+    int ok = format_ok & fields_valid(year, month, day);
+    out->year = year & -ok;
+    out->month = month & -ok;
+    out->day = day & -ok;
+    return ok;
+#else
+    int ok = parse_date(s, DATE_LEN, out);
+    if (!ok) {
+        out->year = out->month = out->day = 0;
+    }
+    return ok;
+#endif
+}
+
+// Parse NUL-terminated strings. invalid must have room for (n + 63) / 64
+// words; bit i is set when strings[i] is not a valid date, and out[i] is
+// then zeroed. Returns the number of valid dates.
+size_t parse_dates(const char *const *strings, size_t n, Date *out, uint64_t *invalid) {
+    init_tables();
+    memset(invalid, 0, (n + 63) / 64 * sizeof(uint64_t));
+    size_t valid = 0;
+    char buf[16] = {0};
+    for (size_t i = 0; i < n; i++) {
+        // Copy into a padded buffer so the 16-byte load never runs past
+        // the end of a short string
+        size_t len = strnlen(strings[i], DATE_LEN + 1);
+        int ok = 0;
+        if (len == DATE_LEN) {
+            memcpy(buf, strings[i], DATE_LEN);
+            ok = parse_date16(buf, &out[i]);
+        } else {
+            out[i].year = out[i].month = out[i].day = 0;
+        }
+        mark(invalid, i, !ok);
+        valid += ok;
+    }
+    return valid;
+}
+
+// Parse n fixed-width records of DATE_LEN bytes, stride bytes apart
+// (stride 11 for one date per line). Same output convention as parse_dates.
+size_t parse_dates_fixed(const char *buf, size_t stride, size_t n, Date *out, uint64_t *invalid) {
+    init_tables();
+    if (n == 0) {
+        return 0;
+    }
+    size_t valid = 0;
+    size_t total = (n - 1) * stride + DATE_LEN;
+    char tail[16] = {0};
+
+    // Build each 64-bit mask word in a register and store it once
+    for (size_t base = 0; base < n; base += 64) {
+        size_t end = n - base < 64 ? n : base + 64;
+        uint64_t bad = 0;
+        for (size_t i = base; i < end; i++) {
+            const char *s = buf + i * stride;
+            // Records near the end of the buffer go through a padded copy
+            if (i * stride + 16 > total) {
+                memcpy(tail, s, DATE_LEN);
+                s = tail;
+            }
+            int ok = parse_date16(s, &out[i]);
+            bad |= (uint64_t)!ok << (i - base);
+            valid += ok;
+        }
+        invalid[base / 64] = bad;
+    }
+    return valid;
+}
+
+// --- Benchmark ---
+
+static double elapsed_ms(clock_t start, clock_t end) {
+    return (double)(end - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+void benchmark(void) {
+    size_t n = BENCH_COUNT;
+    const size_t stride = DATE_LEN + 1;
+    char *text = malloc(n * stride + 1);
+    Date *dates = malloc(n * sizeof(Date));
+    Date *check = malloc(n * sizeof(Date));
+    uint64_t *invalid = malloc((n + 63) / 64 * sizeof(uint64_t));
+    if (text == NULL || dates == NULL || check == NULL || invalid == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        goto done;
+    }
+
+    // Newline-separated dates; about 1 in 16 is deliberately broken
+    srand(38);
+    for (size_t i = 0; i < n; i++) {
+        unsigned y = 1 + (unsigned)rand() % MAX_YEAR;
+        unsigned m = 1 + (unsigned)rand() % 12;
+        unsigned d = 1 + (unsigned)rand() % 31;
+        char *p = text + i * stride;
+        snprintf(p, stride + 1, "%04u-%02u-%02u\n", y, m, d);
+        if (rand() % 16 == 0) {
+            p[rand() % DATE_LEN] = "x-/0"[rand() % 4];
+        }
+    }
+
+    // Touch the output arrays up front so page faults are not timed
+    memset(dates, 0, n * sizeof(Date));
+    memset(check, 0, n * sizeof(Date));
+
+    printf("\n=== Benchmark: %d dates ===\n", BENCH_COUNT);
+    clock_t start, end;
+
+    start = clock();
+    size_t sscanf_valid = 0;
+    for (size_t i = 0; i < n; i++) {
+        // sscanf calls strlen on its input, so give it one line at a time
+        char line[DATE_LEN + 2] = {0};
+        memcpy(line, text + i * stride, DATE_LEN + 1);
+        Date d;
+        int consumed = 0;
+        if (sscanf(line, "%4d-%2d-%2d%n", &d.year, &d.month, &d.day, &consumed) == 3
+            && consumed == DATE_LEN && is_valid_date(d)) {
+            sscanf_valid++;
+        }
+    }
+    end = clock();
+    printf("%-26s %8.1f ms  (%zu valid)\n", "sscanf + is_valid_date",
+           elapsed_ms(start, end), sscanf_valid);
+
+    // Best of BENCH_RUNS for the two fast parsers; a single pass is too
+    // short to be stable
+    double scalar_ms = 0.0, batch_ms = 0.0;
+    size_t scalar_valid = 0, batch_valid = 0;
+    for (int run = 0; run < BENCH_RUNS; run++) {
+        start = clock();
+        scalar_valid = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (parse_date(text + i * stride, DATE_LEN, &check[i])) {
+                scalar_valid++;
+            } else {
+                check[i].year = check[i].month = check[i].day = 0;
+            }
+        }
+        end = clock();
+        if (run == 0 || elapsed_ms(start, end) < scalar_ms) {
+            scalar_ms = elapsed_ms(start, end);
+        }
+
+        start = clock();
+        batch_valid = parse_dates_fixed(text, stride, n, dates, invalid);
+        end = clock();
+        if (run == 0 || elapsed_ms(start, end) < batch_ms) {
+            batch_ms = elapsed_ms(start, end);
+        }
+    }
+    printf("%-26s %8.1f ms  (%zu valid)\n", "parse_date (scalar)", scalar_ms, scalar_valid);
+    printf("%-26s %8.1f ms  (%zu valid, %.0f M dates/s)\n", "parse_dates_fixed (batch)",
+           batch_ms, batch_valid, batch_ms > 0 ? n / batch_ms / 1e3 : 0.0);
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (dates[i].year != check[i].year || dates[i].month != check[i].month
+            || dates[i].day != check[i].day) {
+            mismatches++;
+        }
+    }
+    printf("Batch vs scalar mismatches: %zu\n", mismatches);
+
+done:
+    free(text);
+    free(dates);
+    free(check);
+    free(invalid);
+}
@@ -16,13 +16,14 @@
  *   | Bob     | 25  | Los Angeles |
  *   | Charlie | 35  | Chicago     |
  *
- * Compile: cc -Wall -o ex03_csv_parser ex03_csv_parser.c
+ * Compile: cc -Wall -o ex03_csv_parser ex03_csv_parser.c ../common/fastfmt.c
  * Run: ./ex03_csv_parser data.csv
  */
 
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include "../common/fastfmt.h"
 
 #define MAX_LINE 1024
 #define MAX_FIELDS 10
@@ -91,11 +92,16 @@ int parse_line(char *line, char fields[][MAX_FIELD_LEN], int max_fields) {
 }
 
 void print_row(char fields[][MAX_FIELD_LEN], int num_fields, int widths[]) {
-    printf("|");
+    FmtSink out;
+    fmt_sink_init(&out, stdout);
+    fmt_char(&out, '|');
     for (int i = 0; i < num_fields; i++) {
-        printf(" %-*s |", widths[i], fields[i]);
+        fmt_char(&out, ' ');
+        fmt_str_pad(&out, fields[i], widths[i]);
+        fmt_str(&out, " |");
     }
-    printf("\n");
+    fmt_char(&out, '\n');
+    fmt_flush(&out);
 }
 
 void print_separator(int widths[], int num_fields) {
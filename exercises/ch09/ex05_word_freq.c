@@ -0,0 +1,506 @@
+/*
+ * Exercise 9.5: Word Frequency Counter
+ *
+ * Find the K most frequent words in a (possibly huge) text file.
+ *
+ * Python version:
+ *   from collections import Counter
+ *   with open("corpus.txt") as f:
+ *       counts = Counter(f.read().split())
+ *   for word, n in counts.most_common(10):
+ *       print(n, word)
+ *
+ * C has no dict or Counter, so this builds the pieces:
+ *   - Words come from the shared tokenizer in ../common/wordsplit.c
+ *     (same definition of "word" as wc and count_words).
+ *   - An open-addressing hash map with Robin Hood probing: on a
+ *     collision, the entry that is further from its home slot keeps the
+ *     spot. That keeps probe sequences short and all entries in one flat
+ *     array, which is much friendlier to the cache than chained buckets.
+ *   - Key bytes are copied into an arena (big malloc'd blocks handed out
+ *     by bumping a pointer), so there is one malloc per 1 MiB of keys
+ *     instead of one per word.
+ *   - Top-K uses a min-heap of size K, like heapq.nlargest().
+ *
+ * With -t N the file is split into N ranges (at whitespace) and each
+ * thread fills its own map; the maps are merged at the end.
+ *
+ * Compile: cc -Wall -O2 -pthread -o ex05_word_freq ex05_word_freq.c ../common/wordsplit.c
+ * Run: ./ex05_word_freq corpus.txt
+ *      ./ex05_word_freq -k 20 -t 4 corpus.txt
+ *      cat corpus.txt | ./ex05_word_freq
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../common/wordsplit.h"
+
+#define ARENA_BLOCK_SIZE (1 << 20)
+#define MAP_INITIAL_CAPACITY 1024   // Must be a power of two
+#define MAX_THREADS 64
+
+// --- Arena ---
+
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+    size_t used;
+    size_t size;
+    char data[];
+} ArenaBlock;
+
+typedef struct {
+    ArenaBlock *head;
+} Arena;
+
+// --- Hash map ---
+
+typedef struct {
+    const char *key;   // Points into an arena; NULL marks an empty slot
+    uint32_t len;
+    uint32_t dist;     // Distance from the slot the hash points to
+    uint64_t hash;
+    long count;
+} Entry;
+
+typedef struct {
+    Entry *slots;
+    size_t capacity;
+    size_t size;
+    Arena arena;
+} WordMap;
+
+typedef struct {
+    const char *buf;
+    size_t len;
+    WordMap map;
+    int ok;
+} Worker;
+
+// Function prototypes
+void arena_init(Arena *a);
+char *arena_copy(Arena *a, const char *src, size_t len);
+void arena_free(Arena *a);
+
+uint64_t hash_bytes(const char *s, size_t len);
+int map_init(WordMap *m);
+int map_add(WordMap *m, const char *word, size_t len, uint64_t hash, long count);
+void map_free(WordMap *m);
+
+size_t top_k(const WordMap *m, const Entry **out, size_t k);
+
+int count_range(Worker *w);
+void *worker_main(void *arg);
+const char *load_input(const char *filename, size_t *len, int *mapped);
+
+int main(int argc, char *argv[]) {
+    size_t k = 10;
+    int threads = 1;
+    const char *filename = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+            k = (size_t)atol(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (filename == NULL) {
+            filename = argv[i];
+        } else {
+            fprintf(stderr, "Usage: %s [-k top] [-t threads] [file]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (k == 0 || threads < 1 || threads > MAX_THREADS) {
+        fprintf(stderr, "Need -k >= 1 and 1 <= -t <= %d\n", MAX_THREADS);
+        return 1;
+    }
+
+    size_t len;
+    int mapped;
+    const char *text = load_input(filename, &len, &mapped);
+    if (text == NULL) {
+        return 1;
+    }
+
+    // Split the input into ranges that end on whitespace, so no word
+    // is cut in half between two threads.
+    Worker workers[MAX_THREADS];
+    size_t start = 0;
+    for (int t = 0; t < threads; t++) {
+        size_t end = (t == threads - 1) ? len : len / threads * (t + 1);
+        if (end < start) {
+            end = start;
+        }
+        while (end < len && !ws_is_space((unsigned char)text[end])) {
+            end++;
+        }
+        workers[t].buf = text + start;
+        workers[t].len = end - start;
+        start = end;
+    }
+
+    pthread_t tids[MAX_THREADS];
+    int started[MAX_THREADS] = {0};
+    for (int t = 1; t < threads; t++) {
+        started[t] = pthread_create(&tids[t], NULL, worker_main, &workers[t]) == 0;
+        if (!started[t]) {
+            // Fall back to doing this range on the main thread
+            count_range(&workers[t]);
+        }
+    }
+    count_range(&workers[0]);
+
+    int ok = workers[0].ok;
+    for (int t = 1; t < threads; t++) {
+        if (started[t]) {
+            pthread_join(tids[t], NULL);
+        }
+        ok = ok && workers[t].ok;
+    }
+
+    // Merge every other map into the first (keys are copied into its arena)
+    WordMap *total = &workers[0].map;
+    for (int t = 1; t < threads && ok; t++) {
+        WordMap *m = &workers[t].map;
+        for (size_t i = 0; i < m->capacity && ok; i++) {
+            Entry *e = &m->slots[i];
+            if (e->key != NULL) {
+                ok = map_add(total, e->key, e->len, e->hash, e->count);
+            }
+        }
+    }
+
+    if (!ok) {
+        fprintf(stderr, "Out of memory\n");
+    } else {
+        const Entry **best = malloc(k * sizeof(Entry *));
+        if (best == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            ok = 0;
+        } else {
+            size_t n = top_k(total, best, k);
+            for (size_t i = 0; i < n; i++) {
+                printf("%7ld %.*s\n", best[i]->count, (int)best[i]->len, best[i]->key);
+            }
+            fprintf(stderr, "%zu distinct words\n", total->size);
+            free(best);
+        }
+    }
+
+    for (int t = 0; t < threads; t++) {
+        map_free(&workers[t].map);
+    }
+    if (mapped) {
+        munmap((void *)text, len);
+    } else {
+        free((void *)text);
+    }
+    return ok ? 0 : 1;
+}
+
+// --- Arena ---
+
+void arena_init(Arena *a) {
+    a->head = NULL;
+}
+
+char *arena_copy(Arena *a, const char *src, size_t len) {
+    ArenaBlock *b = a->head;
+    if (b == NULL || b->size - b->used < len) {
+        size_t size = len > ARENA_BLOCK_SIZE ? len : ARENA_BLOCK_SIZE;
+        b = malloc(sizeof(ArenaBlock) + size);
+        if (b == NULL) {
+            return NULL;
+        }
+        b->next = a->head;
+        b->used = 0;
+        b->size = size;
+        a->head = b;
+    }
+    char *dst = b->data + b->used;
+    memcpy(dst, src, len);
+    b->used += len;
+    return dst;
+}
+
+void arena_free(Arena *a) {
+    ArenaBlock *b = a->head;
+    while (b != NULL) {
+        ArenaBlock *next = b->next;
+        free(b);
+        b = next;
+    }
+    a->head = NULL;
+}
+
+// --- Hash map ---
+
+uint64_t hash_bytes(const char *s, size_t len) {
+    // Mix 8 bytes per step, then a murmur3-style finalizer
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ len;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t chunk;
+        memcpy(&chunk, s + i, 8);
+        h = (h ^ chunk) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 32;
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, s + i, len - i);
+    h = (h ^ tail) * 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    return h;
+}
+
+int map_init(WordMap *m) {
+    m->capacity = MAP_INITIAL_CAPACITY;
+    m->size = 0;
+    m->slots = calloc(m->capacity, sizeof(Entry));
+    arena_init(&m->arena);
+    return m->slots != NULL;
+}
+
+// Place an entry that is known not to be in the map yet
+static void map_place(Entry *slots, size_t capacity, Entry e) {
+    size_t mask = capacity - 1;
+    size_t i = e.hash & mask;
+    e.dist = 0;
+    while (slots[i].key != NULL) {
+        if (slots[i].dist < e.dist) {
+            // Robin Hood: the richer entry (closer to home) moves on
+            Entry tmp = slots[i];
+            slots[i] = e;
+            e = tmp;
+        }
+        i = (i + 1) & mask;
+        e.dist++;
+    }
+    slots[i] = e;
+}
+
+static int map_grow(WordMap *m) {
+    size_t new_capacity = m->capacity * 2;
+    Entry *slots = calloc(new_capacity, sizeof(Entry));
+    if (slots == NULL) {
+        return 0;
+    }
+    for (size_t i = 0; i < m->capacity; i++) {
+        if (m->slots[i].key != NULL) {
+            map_place(slots, new_capacity, m->slots[i]);
+        }
+    }
+    free(m->slots);
+    m->slots = slots;
+    m->capacity = new_capacity;
+    return 1;
+}
+
+// Add count to word's total, inserting it if new. The key is copied
+// into the map's arena on first sight. Returns 0 on allocation failure.
+int map_add(WordMap *m, const char *word, size_t len, uint64_t hash, long count) {
+    size_t mask = m->capacity - 1;
+    size_t i = hash & mask;
+    uint32_t dist = 0;
+
+    // Robin Hood lets us stop early: once we pass an entry that is
+    // closer to its home than we would be, the word cannot be further on.
+    while (m->slots[i].key != NULL && m->slots[i].dist >= dist) {
+        Entry *e = &m->slots[i];
+        if (e->hash == hash && e->len == len && memcmp(e->key, word, len) == 0) {
+            e->count += count;
+            return 1;
+        }
+        i = (i + 1) & mask;
+        dist++;
+    }
+
+    // Keep the load factor under 3/4
+    if ((m->size + 1) * 4 > m->capacity * 3) {
+        if (!map_grow(m)) {
+            return 0;
+        }
+    }
+
+    Entry e;
+    e.key = arena_copy(&m->arena, word, len);
+    if (e.key == NULL) {
+        return 0;
+    }
+    e.len = (uint32_t)len;
+    e.hash = hash;
+    e.count = count;
+    map_place(m->slots, m->capacity, e);
+    m->size++;
+    return 1;
+}
+
+void map_free(WordMap *m) {
+    free(m->slots);
+    m->slots = NULL;
+    m->capacity = 0;
+    m->size = 0;
+    arena_free(&m->arena);
+}
+
+// --- Top-K ---
+
+static int entry_less(const Entry *a, const Entry *b) {
+    // Lower count first; ties broken so the output order is stable
+    if (a->count != b->count) {
+        return a->count < b->count;
+    }
+    size_t n = a->len < b->len ? a->len : b->len;
+    int c = memcmp(a->key, b->key, n);
+    if (c != 0) {
+        return c > 0;
+    }
+    return a->len > b->len;
+}
+
+static void sift_down(const Entry **heap, size_t n, size_t i) {
+    while (1) {
+        size_t smallest = i;
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+        if (left < n && entry_less(heap[left], heap[smallest])) smallest = left;
+        if (right < n && entry_less(heap[right], heap[smallest])) smallest = right;
+        if (smallest == i) {
+            return;
+        }
+        const Entry *tmp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = tmp;
+        i = smallest;
+    }
+}
+
+// Fill out[] with up to k entries, most frequent first. Returns how many.
+size_t top_k(const WordMap *m, const Entry **out, size_t k) {
+    size_t n = 0;
+
+    // out[] is a min-heap: out[0] is the weakest of the current top K
+    for (size_t i = 0; i < m->capacity; i++) {
+        const Entry *e = &m->slots[i];
+        if (e->key == NULL) {
+            continue;
+        }
+        if (n < k) {
+            out[n++] = e;
+            if (n == k) {
+                for (size_t j = k / 2; j-- > 0;) {
+                    sift_down(out, n, j);
+                }
+            }
+        } else if (entry_less(out[0], e)) {
+            out[0] = e;
+            sift_down(out, n, 0);
+        }
+    }
+    if (n < k) {
+        for (size_t j = n / 2; j-- > 0;) {
+            sift_down(out, n, j);
+        }
+    }
+
+    // Heap sort in place: repeatedly move the minimum to the end
+    for (size_t end = n; end > 1; end--) {
+        const Entry *tmp = out[0];
+        out[0] = out[end - 1];
+        out[end - 1] = tmp;
+        sift_down(out, end - 1, 0);
+    }
+    return n;
+}
+
+// --- Counting ---
+
+int count_range(Worker *w) {
+    w->ok = map_init(&w->map);
+    if (!w->ok) {
+        return 0;
+    }
+
+    WordTokenizer t;
+    WordSpan span;
+    ws_tokenizer_init(&t, w->buf, w->len);
+    while (ws_next_word(&t, &span)) {
+        const char *word = w->buf + span.offset;
+        if (!map_add(&w->map, word, span.length, hash_bytes(word, span.length), 1)) {
+            w->ok = 0;
+            break;
+        }
+    }
+    return w->ok;
+}
+
+void *worker_main(void *arg) {
+    count_range(arg);
+    return NULL;
+}
+
+// Map a regular file into memory, or read all of stdin / a pipe.
+const char *load_input(const char *filename, size_t *len, int *mapped) {
+    int fd = STDIN_FILENO;
+    if (filename != NULL) {
+        fd = open(filename, O_RDONLY);
+        if (fd < 0) {
+            perror(filename);
+            return NULL;
+        }
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            if (fd != STDIN_FILENO) close(fd);
+            *len = (size_t)st.st_size;
+            *mapped = 1;
+            return p;
+        }
+    }
+
+    size_t capacity = 1 << 20;
+    size_t used = 0;
+    char *buf = malloc(capacity);
+    while (buf != NULL) {
+        if (used == capacity) {
+            char *bigger = realloc(buf, capacity * 2);
+            if (bigger == NULL) {
+                free(buf);
+                buf = NULL;
+                break;
+            }
+            buf = bigger;
+            capacity *= 2;
+        }
+        ssize_t n = read(fd, buf + used, capacity - used);
+        if (n < 0) {
+            perror("read");
+            free(buf);
+            buf = NULL;
+            break;
+        }
+        if (n == 0) {
+            break;
+        }
+        used += (size_t)n;
+    }
+    if (fd != STDIN_FILENO) close(fd);
+    if (buf == NULL) {
+        fprintf(stderr, "Could not read input\n");
+        return NULL;
+    }
+
+    *len = used;
+    *mapped = 0;
+    return buf;
+}
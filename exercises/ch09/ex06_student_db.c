@@ -0,0 +1,515 @@
+/*
+ * Exercise 9.6: Memory-Mapped Student Database
+ *
+ * Exercise 8.1's students only exist in an initializer in main(). This
+ * program keeps them in a binary file that is opened with mmap(): the
+ * file's bytes appear directly in memory, so "loading" the database is
+ * just checking a header. No parsing, no reading records one by one, and
+ * opening a file with 10 million students takes as long as opening one
+ * with 5.
+ *
+ * Python equivalent (roughly):
+ *   import mmap, struct
+ *   with open("students.db", "r+b") as f:
+ *       m = mmap.mmap(f.fileno(), 0)
+ *       count = struct.unpack_from("<Q", m, 16)[0]
+ *
+ * File layout (version 1, native byte order):
+ *
+ *   +------------------+  offset 0
+ *   | DbHeader         |  magic, version, sizes, committed record count
+ *   +------------------+  offset 4096
+ *   | DiskStudent[cap] |  fixed 64-byte records, in insertion order
+ *   +------------------+  index_offset
+ *   | IdBucket[2*cap]  |  hash index: id -> record number
+ *   +------------------+
+ *
+ * Appends go straight into the mapping. They only become durable at the
+ * next sync, which flushes the records and index first and THEN bumps
+ * the header's record count, so a crash can lose the last unsynced batch
+ * but never leaves the header pointing at half-written records. Syncing
+ * every BATCH_SIZE appends instead of every append is what makes appends
+ * fast: each sync writes out every index page touched since the last
+ * one, and hashed ids touch pages all over the index. A CSV bulk load
+ * turns periodic syncs off and syncs once at the end.
+ *
+ * When the record area fills up, the file is doubled and the index is
+ * rebuilt after the new record area.
+ *
+ * Commands:
+ *   ./ex06_student_db create students.db
+ *   ./ex06_student_db load students.db students.csv   (Name,ID,GPA rows)
+ *   ./ex06_student_db add students.db "Frank Miller" 1006 3.95
+ *   ./ex06_student_db get students.db 1003
+ *   ./ex06_student_db list students.db
+ *   ./ex06_student_db bench students.db 1000000
+ *
+ * Compile: cc -Wall -O2 -o ex06_student_db ex06_student_db.c
+ * Run: ./ex06_student_db create students.db && ./ex06_student_db load students.db students.csv
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define DB_MAGIC "STUDB\0\0\0"
+#define DB_VERSION 1
+#define DB_PAGE_SIZE 4096
+#define DB_INITIAL_CAPACITY 1024
+#define BATCH_SIZE 65536   // Appends between automatic syncs
+#define MAX_LINE 1024
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t record_count;      // Committed (synced) records
+    uint64_t record_capacity;
+    uint64_t records_offset;
+    uint64_t index_offset;
+    uint64_t index_buckets;     // Power of two, 2 * record_capacity
+} DbHeader;
+
+typedef struct {
+    char name[48];
+    int32_t id;
+    int32_t reserved;
+    double gpa;
+} DiskStudent;
+
+typedef struct {
+    int32_t id;
+    uint32_t record;   // Record number + 1; 0 means empty
+} IdBucket;
+
+typedef struct {
+    int fd;
+    unsigned char *map;
+    size_t map_size;
+    DbHeader *header;
+    DiskStudent *records;
+    IdBucket *index;
+    uint64_t buckets;   // Number of IdBuckets in index
+    uint64_t count;     // Includes appends not yet synced
+    uint64_t synced;    // Records already flushed to disk
+    uint64_t batch_size;   // Sync after this many appends; 0 = only on request
+} StudentDb;
+
+// Function prototypes
+int db_create(const char *path);
+int db_open(StudentDb *db, const char *path);
+int db_append(StudentDb *db, const char *name, int id, double gpa);
+const DiskStudent *db_find(const StudentDb *db, int id);
+int db_sync(StudentDb *db);
+int db_close(StudentDb *db);
+long db_load_csv(StudentDb *db, const char *csv_path);
+
+void print_student(const DiskStudent *s);
+int run_benchmark(const char *path, long n);
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s create|load|add|get|list|bench <db> [args]\n", argv[0]);
+        return 1;
+    }
+    const char *cmd = argv[1];
+    const char *path = argv[2];
+
+    if (strcmp(cmd, "create") == 0) {
+        return db_create(path) ? 0 : 1;
+    }
+    if (strcmp(cmd, "bench") == 0) {
+        return run_benchmark(path, argc > 3 ? atol(argv[3]) : 1000000) ? 0 : 1;
+    }
+
+    StudentDb db;
+    if (!db_open(&db, path)) {
+        return 1;
+    }
+
+    int ok = 1;
+    if (strcmp(cmd, "load") == 0 && argc == 4) {
+        long n = db_load_csv(&db, argv[3]);
+        ok = n >= 0;
+        if (ok) {
+            printf("Loaded %ld students (%llu total)\n", n, (unsigned long long)db.count);
+        }
+    } else if (strcmp(cmd, "add") == 0 && argc == 6) {
+        ok = db_append(&db, argv[3], atoi(argv[4]), atof(argv[5])) == 1;
+    } else if (strcmp(cmd, "get") == 0 && argc == 4) {
+        const DiskStudent *s = db_find(&db, atoi(argv[3]));
+        if (s != NULL) {
+            print_student(s);
+        } else {
+            printf("Student not found.\n");
+        }
+    } else if (strcmp(cmd, "list") == 0) {
+        for (uint64_t i = 0; i < db.count; i++) {
+            print_student(&db.records[i]);
+        }
+    } else {
+        fprintf(stderr, "Unknown command or wrong arguments: %s\n", cmd);
+        ok = 0;
+    }
+
+    ok = db_close(&db) && ok;
+    return ok ? 0 : 1;
+}
+
+void print_student(const DiskStudent *s) {
+    printf("ID: %d, Name: %s, GPA: %.2f\n", s->id, s->name, s->gpa);
+}
+
+// --- Layout helpers ---
+
+static uint64_t index_offset_for(uint64_t capacity) {
+    return DB_PAGE_SIZE + capacity * sizeof(DiskStudent);
+}
+
+static size_t file_size_for(uint64_t capacity) {
+    size_t size = index_offset_for(capacity) + 2 * capacity * sizeof(IdBucket);
+    return (size + DB_PAGE_SIZE - 1) / DB_PAGE_SIZE * DB_PAGE_SIZE;
+}
+
+static void db_attach(StudentDb *db) {
+    db->header = (DbHeader *)db->map;
+    db->records = (DiskStudent *)(db->map + db->header->records_offset);
+    db->index = (IdBucket *)(db->map + db->header->index_offset);
+    db->buckets = db->header->index_buckets;
+}
+
+static uint64_t hash_id(int id, uint64_t buckets) {
+    return (((uint64_t)(uint32_t)id * 11400714819323198485ull) >> 32) & (buckets - 1);
+}
+
+// A bucket only counts if it points at an existing record with its id.
+// Buckets left behind by appends that were never synced fail this test,
+// which is why opening never has to clean the index up.
+static int bucket_valid(const StudentDb *db, const IdBucket *b) {
+    return b->record != 0 && b->record - 1 < db->count
+        && db->records[b->record - 1].id == b->id;
+}
+
+static void index_insert(StudentDb *db, int id, uint64_t record) {
+    uint64_t mask = db->buckets - 1;
+    uint64_t i = hash_id(id, db->buckets);
+    while (bucket_valid(db, &db->index[i]) && db->index[i].id != id) {
+        i = (i + 1) & mask;
+    }
+    db->index[i].id = id;
+    db->index[i].record = (uint32_t)(record + 1);
+}
+
+// --- Database ---
+
+int db_create(const char *path) {
+    int fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        perror(path);
+        return 0;
+    }
+
+    DbHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DB_MAGIC, sizeof(header.magic));
+    header.version = DB_VERSION;
+    header.record_size = sizeof(DiskStudent);
+    header.record_capacity = DB_INITIAL_CAPACITY;
+    header.records_offset = DB_PAGE_SIZE;
+    header.index_offset = index_offset_for(DB_INITIAL_CAPACITY);
+    header.index_buckets = 2 * DB_INITIAL_CAPACITY;
+
+    // ftruncate() fills the file with zeros: an empty index
+    int ok = ftruncate(fd, (off_t)file_size_for(DB_INITIAL_CAPACITY)) == 0
+          && pwrite(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header)
+          && fsync(fd) == 0;
+    if (!ok) {
+        perror(path);
+    }
+    close(fd);
+    return ok;
+}
+
+int db_open(StudentDb *db, const char *path) {
+    db->fd = open(path, O_RDWR);
+    if (db->fd < 0) {
+        perror(path);
+        return 0;
+    }
+
+    struct stat st;
+    if (fstat(db->fd, &st) != 0 || (size_t)st.st_size < DB_PAGE_SIZE) {
+        fprintf(stderr, "%s: not a student database\n", path);
+        close(db->fd);
+        return 0;
+    }
+
+    db->map_size = (size_t)st.st_size;
+    db->map = mmap(NULL, db->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, db->fd, 0);
+    if (db->map == MAP_FAILED) {
+        perror("mmap");
+        close(db->fd);
+        return 0;
+    }
+
+    // All the "loading" there is: validate the header
+    const DbHeader *h = (const DbHeader *)db->map;
+    int valid = memcmp(h->magic, DB_MAGIC, sizeof(h->magic)) == 0
+             && h->version == DB_VERSION
+             && h->record_size == sizeof(DiskStudent)
+             && h->record_count <= h->record_capacity
+             && h->records_offset == DB_PAGE_SIZE
+             && h->index_buckets == 2 * h->record_capacity
+             && h->index_offset == index_offset_for(h->record_capacity)
+             && file_size_for(h->record_capacity) <= db->map_size;
+    if (!valid) {
+        fprintf(stderr, "%s: not a version %d student database\n", path, DB_VERSION);
+        munmap(db->map, db->map_size);
+        close(db->fd);
+        return 0;
+    }
+
+    db_attach(db);
+    db->count = db->header->record_count;
+    db->synced = db->count;
+    db->batch_size = BATCH_SIZE;
+    return 1;
+}
+
+static int db_grow(StudentDb *db) {
+    // Commit what we have so the old layout stays valid if we crash
+    if (!db_sync(db)) {
+        return 0;
+    }
+
+    uint64_t capacity = db->header->record_capacity * 2;
+    size_t size = file_size_for(capacity);
+    if (ftruncate(db->fd, (off_t)size) != 0) {
+        perror("ftruncate");
+        return 0;
+    }
+    // Map the bigger file before letting go of the old mapping, so a
+    // failure leaves db exactly as it was
+    unsigned char *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, db->fd, 0);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        return 0;
+    }
+    munmap(db->map, db->map_size);
+    db->map = map;
+    db->map_size = size;
+    db_attach(db);
+
+    // The new index lies past the old end of file, so it is all zeros
+    uint64_t index_offset = index_offset_for(capacity);
+    db->index = (IdBucket *)(db->map + index_offset);
+    db->buckets = 2 * capacity;
+    for (uint64_t i = 0; i < db->count; i++) {
+        index_insert(db, db->records[i].id, i);
+    }
+    if (msync(db->map, size, MS_SYNC) != 0) {
+        perror("msync");
+        return 0;
+    }
+
+    // Switch the header over last
+    db->header->record_capacity = capacity;
+    db->header->index_offset = index_offset;
+    db->header->index_buckets = db->buckets;
+    if (msync(db->map, DB_PAGE_SIZE, MS_SYNC) != 0) {
+        perror("msync");
+        return 0;
+    }
+    return 1;
+}
+
+// Returns 1 on success, 0 on a duplicate id, -1 on an I/O error
+int db_append(StudentDb *db, const char *name, int id, double gpa) {
+    if (db_find(db, id) != NULL) {
+        fprintf(stderr, "Duplicate id %d\n", id);
+        return 0;
+    }
+    if (db->count == db->header->record_capacity && !db_grow(db)) {
+        return -1;
+    }
+
+    DiskStudent *s = &db->records[db->count];
+    memset(s, 0, sizeof(*s));
+    strncpy(s->name, name, sizeof(s->name) - 1);
+    s->id = id;
+    s->gpa = gpa;
+    db->count++;
+    index_insert(db, id, db->count - 1);
+
+    if (db->batch_size != 0 && db->count - db->synced >= db->batch_size) {
+        return db_sync(db) ? 1 : -1;
+    }
+    return 1;
+}
+
+const DiskStudent *db_find(const StudentDb *db, int id) {
+    uint64_t mask = db->buckets - 1;
+    uint64_t i = hash_id(id, db->buckets);
+    // Probe until a truly empty bucket; stale buckets are skipped
+    while (db->index[i].record != 0) {
+        if (db->index[i].id == id && bucket_valid(db, &db->index[i])) {
+            return &db->records[db->index[i].record - 1];
+        }
+        i = (i + 1) & mask;
+    }
+    return NULL;
+}
+
+int db_sync(StudentDb *db) {
+    if (db->count == db->synced) {
+        return 1;
+    }
+    // 1. Records and index
+    size_t page_mask = (size_t)sysconf(_SC_PAGESIZE) - 1;
+    size_t first = (db->header->records_offset + db->synced * sizeof(DiskStudent)) & ~page_mask;
+    size_t last = db->header->records_offset + db->count * sizeof(DiskStudent);
+    if (msync(db->map + first, last - first, MS_SYNC) != 0
+        || msync(db->index, db->buckets * sizeof(IdBucket), MS_SYNC) != 0) {
+        perror("msync");
+        return 0;
+    }
+    // 2. Then the header that makes them visible
+    db->header->record_count = db->count;
+    if (msync(db->map, DB_PAGE_SIZE, MS_SYNC) != 0) {
+        perror("msync");
+        return 0;
+    }
+    db->synced = db->count;
+    return 1;
+}
+
+int db_close(StudentDb *db) {
+    int ok = db_sync(db);
+    munmap(db->map, db->map_size);
+    close(db->fd);
+    db->map = NULL;
+    return ok;
+}
+
+// Load rows of Name,ID,GPA (first line is a header). Returns the number
+// of students added, or -1 on error. Syncs once at the end.
+long db_load_csv(StudentDb *db, const char *csv_path) {
+    FILE *f = fopen(csv_path, "r");
+    if (f == NULL) {
+        perror(csv_path);
+        return -1;
+    }
+
+    char line[MAX_LINE];
+    long added = 0;
+    long line_num = 0;
+    int result = 1;
+    uint64_t saved_batch_size = db->batch_size;
+    db->batch_size = 0;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        line_num++;
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line_num == 1 || line[0] == '\0') {
+            continue;   // Header row or blank line
+        }
+
+        char *name = line;
+        char *id_field = strchr(name, ',');
+        char *gpa_field = id_field ? strchr(id_field + 1, ',') : NULL;
+        if (gpa_field == NULL) {
+            fprintf(stderr, "%s:%ld: expected Name,ID,GPA\n", csv_path, line_num);
+            continue;
+        }
+        *id_field++ = '\0';
+        *gpa_field++ = '\0';
+
+        result = db_append(db, name, atoi(id_field), atof(gpa_field));
+        if (result < 0) {
+            break;   // The database can't take more; stop loading
+        }
+        added += result;
+    }
+
+    fclose(f);
+    db->batch_size = saved_batch_size;
+    if (result < 0 || !db_sync(db)) {
+        return -1;
+    }
+    return added;
+}
+
+// --- Benchmark ---
+
+static double seconds_since(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+// Fill a fresh database with n students, syncing every batch_size appends
+static int fill(const char *path, long n, uint64_t batch_size) {
+    unlink(path);
+    if (!db_create(path)) {
+        return 0;
+    }
+
+    StudentDb db;
+    struct timespec start;
+    if (!db_open(&db, path)) {
+        return 0;
+    }
+    db.batch_size = batch_size;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    char name[48];
+    for (long i = 0; i < n; i++) {
+        snprintf(name, sizeof(name), "Student %ld", i);
+        if (db_append(&db, name, (int)(100000 + i), (i % 401) / 100.0) != 1) {
+            db_close(&db);
+            return 0;
+        }
+    }
+    if (!db_close(&db)) {
+        return 0;
+    }
+    if (batch_size == 0) {
+        printf("Append %ld records, one sync at the end: %.3f s\n", n, seconds_since(&start));
+    } else {
+        printf("Append %ld records, sync every %llu: %.3f s\n", n,
+               (unsigned long long)batch_size, seconds_since(&start));
+    }
+    return 1;
+}
+
+int run_benchmark(const char *path, long n) {
+    if (!fill(path, n, BATCH_SIZE) || !fill(path, n, 0)) {
+        return 0;
+    }
+
+    StudentDb db;
+    struct timespec start;
+
+    // Restart time: open + one lookup, independent of n
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (!db_open(&db, path)) {
+        return 0;
+    }
+    const DiskStudent *s = db_find(&db, (int)(100000 + n / 2));
+    double open_time = seconds_since(&start);
+    printf("Open + first lookup: %.6f s (%s)\n", open_time, s ? s->name : "not found");
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    long hits = 0;
+    for (long i = 0; i < n; i++) {
+        hits += db_find(&db, (int)(100000 + (i * 7919) % n)) != NULL;
+    }
+    double lookup_time = seconds_since(&start);
+    printf("%ld lookups: %.3f s (%ld hits)\n", n, lookup_time, hits);
+
+    return db_close(&db);
+}
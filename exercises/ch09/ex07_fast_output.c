@@ -0,0 +1,214 @@
+/*
+ * Exercise 9.7: Fast Formatted Output
+ *
+ * Measures how quickly numbers can be turned into text and written out:
+ * printf-family calls against the shared formatter in ../common/fastfmt.c
+ * (which da_print, list_print, print_row, complex_print, print_date and
+ * the calculator's display_result now use).
+ *
+ * Each test writes the same values both ways, first into memory to check
+ * that the text is identical, then to the output file for timing.
+ *
+ * Python equivalent (roughly):
+ *   with open(os.devnull, "w") as f:
+ *       f.write("".join(f"{x:.2f}\n" for x in values))
+ *
+ * Compile: cc -Wall -O2 -o ex07_fast_output ex07_fast_output.c ../common/fastfmt.c
+ * Run: ./ex07_fast_output [output-file]    (default: /dev/null)
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "../common/fastfmt.h"
+
+#define VALUE_COUNT 2000000
+#define CHECK_COUNT 20000
+
+typedef enum { KIND_INT, KIND_FIXED2, KIND_SHORTEST, KIND_DATE } Kind;
+
+typedef struct {
+    Kind kind;
+    const char *label;
+    const char *printf_format;
+} Test;
+
+// Function prototypes
+void write_printf(FILE *out, const Test *t, const int64_t *ints, const double *reals, size_t n);
+void write_fastfmt(FILE *out, const Test *t, const int64_t *ints, const double *reals, size_t n);
+int outputs_match(const Test *t, const int64_t *ints, const double *reals, size_t n);
+double time_writer(void (*writer)(FILE *, const Test *, const int64_t *, const double *, size_t),
+                   FILE *out, const Test *t, const int64_t *ints, const double *reals,
+                   size_t n, long *bytes);
+
+int main(int argc, char *argv[]) {
+    const char *path = argc > 1 ? argv[1] : "/dev/null";
+    FILE *out = fopen(path, "w");
+    if (out == NULL) {
+        perror(path);
+        return 1;
+    }
+
+    int64_t *ints = malloc(VALUE_COUNT * sizeof(int64_t));
+    double *reals = malloc(VALUE_COUNT * sizeof(double));
+    if (ints == NULL || reals == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    srand(42);
+    for (size_t i = 0; i < VALUE_COUNT; i++) {
+        // A spread of magnitudes, like real data
+        int64_t v = ((int64_t)rand() << 31 | rand()) >> (rand() % 48);
+        ints[i] = (rand() & 1) ? v : -v;
+        reals[i] = (double)ints[i] / 1000.0;
+    }
+
+    static const Test tests[] = {
+        {KIND_INT, "integers (%lld)", "%lld\n"},
+        {KIND_FIXED2, "fixed (%.2f)", "%.2f\n"},
+        {KIND_SHORTEST, "shortest (%.17g)", "%.17g\n"},
+        {KIND_DATE, "dates (%04d-%02d-%02d)", "%04d-%02d-%02d\n"},
+    };
+
+    printf("Writing %d values to %s\n\n", VALUE_COUNT, path);
+    printf("%-26s %12s %12s %9s\n", "format", "printf MB/s", "fastfmt MB/s", "speedup");
+    for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+        const Test *t = &tests[i];
+        if (!outputs_match(t, ints, reals, CHECK_COUNT)) {
+            printf("%-26s output differs from printf!\n", t->label);
+            continue;
+        }
+        long printf_bytes, fast_bytes;
+        double printf_s = time_writer(write_printf, out, t, ints, reals, VALUE_COUNT, &printf_bytes);
+        double fast_s = time_writer(write_fastfmt, out, t, ints, reals, VALUE_COUNT, &fast_bytes);
+        printf("%-26s %12.1f %12.1f %8.1fx\n", t->label,
+               printf_bytes / printf_s / 1e6, fast_bytes / fast_s / 1e6, printf_s / fast_s);
+    }
+    printf("\n(shortest: fastfmt prints the shortest round-trip digits, like\n"
+           " Python's repr, where %%.17g always prints 17; same job, fewer bytes)\n");
+
+    fclose(out);
+    free(ints);
+    free(reals);
+    return 0;
+}
+
+// --- Writers ---
+
+static void date_of(int64_t v, int *year, int *month, int *day) {
+    uint64_t u = (uint64_t)v;
+    *year = 1 + (int)(u % 9999);
+    *month = 1 + (int)(u / 9999 % 12);
+    *day = 1 + (int)(u / 9999 / 12 % 28);
+}
+
+void write_printf(FILE *out, const Test *t, const int64_t *ints, const double *reals, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        switch (t->kind) {
+        case KIND_INT:
+            fprintf(out, t->printf_format, (long long)ints[i]);
+            break;
+        case KIND_FIXED2:
+            fprintf(out, t->printf_format, reals[i]);
+            break;
+        case KIND_SHORTEST:
+            fprintf(out, t->printf_format, reals[i]);
+            break;
+        case KIND_DATE: {
+            int y, m, d;
+            date_of(ints[i], &y, &m, &d);
+            fprintf(out, t->printf_format, y, m, d);
+            break;
+        }
+        }
+    }
+}
+
+void write_fastfmt(FILE *out, const Test *t, const int64_t *ints, const double *reals, size_t n) {
+    FmtSink sink;
+    fmt_sink_init(&sink, out);
+    for (size_t i = 0; i < n; i++) {
+        switch (t->kind) {
+        case KIND_INT:
+            fmt_i64(&sink, ints[i]);
+            break;
+        case KIND_FIXED2:
+            fmt_fixed(&sink, reals[i], 2);
+            break;
+        case KIND_SHORTEST:
+            fmt_double(&sink, reals[i]);
+            break;
+        case KIND_DATE: {
+            int y, m, d;
+            date_of(ints[i], &y, &m, &d);
+            fmt_i64_zero_pad(&sink, y, 4);
+            fmt_char(&sink, '-');
+            fmt_i64_zero_pad(&sink, m, 2);
+            fmt_char(&sink, '-');
+            fmt_i64_zero_pad(&sink, d, 2);
+            break;
+        }
+        }
+        fmt_char(&sink, '\n');
+    }
+    fmt_flush(&sink);
+}
+
+// --- Checking and timing ---
+
+// Same text both ways? For shortest, check that the digits read back as
+// the same double instead, since %.17g prints extra digits.
+int outputs_match(const Test *t, const int64_t *ints, const double *reals, size_t n) {
+    char *a = NULL, *b = NULL;
+    size_t a_len = 0, b_len = 0;
+    FILE *fa = open_memstream(&a, &a_len);
+    FILE *fb = open_memstream(&b, &b_len);
+    if (fa == NULL || fb == NULL) {
+        return 0;
+    }
+    write_printf(fa, t, ints, reals, n);
+    write_fastfmt(fb, t, ints, reals, n);
+    fclose(fa);
+    fclose(fb);
+
+    int match;
+    if (t->kind == KIND_SHORTEST) {
+        match = 1;
+        char *line = b;
+        for (size_t i = 0; i < n && match; i++) {
+            char *end;
+            match = strtod(line, &end) == reals[i] && *end == '\n';
+            line = end + 1;
+        }
+    } else {
+        match = a_len == b_len && memcmp(a, b, a_len) == 0;
+    }
+    free(a);
+    free(b);
+    return match;
+}
+
+double time_writer(void (*writer)(FILE *, const Test *, const int64_t *, const double *, size_t),
+                   FILE *out, const Test *t, const int64_t *ints, const double *reals,
+                   size_t n, long *bytes) {
+    // Count the bytes separately: /dev/null has no file position
+    char *mem = NULL;
+    size_t len = 0;
+    FILE *m = open_memstream(&mem, &len);
+    if (m != NULL) {
+        writer(m, t, ints, reals, n);
+        fclose(m);
+        free(mem);
+    }
+    *bytes = (long)len;
+
+    fflush(out);
+    clock_t start = clock();
+    writer(out, t, ints, reals, n);
+    fflush(out);
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    return seconds > 0 ? seconds : 1e-9;
+}
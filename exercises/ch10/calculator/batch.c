@@ -0,0 +1,319 @@
+/*
+ * batch.c - Non-interactive calculator implementation
+ * Exercise 10.1: Multi-file Calculator
+ *
+ * The whole input is read into memory, then cut into one piece per
+ * thread (at line or record boundaries). Each thread looks operations
+ * up in the operations[] table, calls them through the function
+ * pointer, and formats its results into its own in-memory buffer;
+ * the buffers are written out in order at the end.
+ */
+
+#define _GNU_SOURCE
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "batch.h"
+#include "operations.h"
+#include "../../common/fastfmt.h"
+
+#define READ_CHUNK (1 << 20)
+#define MIN_BYTES_PER_THREAD (1 << 20)   // Smaller inputs aren't worth a thread
+#define MAGIC_LEN 8
+
+typedef struct {
+    const char *begin;    // Text: lines in [begin, end)
+    const char *end;
+    const BatchRecord *records;   // Binary: records[0..count)
+    size_t count;
+    double *results;
+    FILE *out;            // Text output goes here
+    char *text;           // The in-memory stream behind out, if any
+    size_t text_len;
+    BatchStats stats;
+    int ok;
+} Job;
+
+// --- Checking one operation ---
+
+// NULL if operation op can be applied with right operand b, otherwise why not
+static const char *check_operands(int op, double b) {
+    if (op < 0 || op >= OPERATION_COUNT) {
+        return "unknown operation";
+    }
+    if (op == OPERATION_DIVIDE && b == 0) {
+        return "division by zero";
+    }
+    return NULL;
+}
+
+// --- Text ---
+
+static const char *skip_blanks(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        p++;
+    }
+    return p;
+}
+
+// Plain decimals like "-12.375" with at most 15 digits: the digits fit
+// a double exactly, and so does 10^k for k <= 22, so one division gives
+// the correctly rounded value - the same answer as strtod, much faster.
+// Returns 0 (and strtod takes over) for anything else.
+static int parse_simple_decimal(const char *s, const char *end, double *value, const char **after) {
+    static const double powers[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+    const char *p = s;
+    int negative = p < end && *p == '-';
+    if (p < end && (*p == '-' || *p == '+')) {
+        p++;
+    }
+    uint64_t digits = 0;
+    int count = 0, decimals = 0;
+    const char *first = p;
+    while (p < end && *p >= '0' && *p <= '9') {
+        digits = digits * 10 + (uint64_t)(*p++ - '0');
+        count++;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && *p >= '0' && *p <= '9') {
+            digits = digits * 10 + (uint64_t)(*p++ - '0');
+            count++;
+            decimals++;
+        }
+    }
+    if (count == 0 || count > 15 || (p < end && (*p == 'e' || *p == 'E' || *p == 'x' || *p == 'X'))
+        || (p - first == 1 && *first == '.')) {
+        return 0;
+    }
+    double v = (double)digits / powers[decimals];
+    *value = negative ? -v : v;
+    *after = p;
+    return 1;
+}
+
+// Number at *p, which must end before line_end
+static int parse_number(const char **p, const char *line_end, double *value) {
+    const char *start = skip_blanks(*p, line_end);
+    char *after;
+    if (start == line_end) {
+        return 0;
+    }
+    const char *simple_end;
+    if (parse_simple_decimal(start, line_end, value, &simple_end)) {
+        *p = simple_end;
+        return 1;
+    }
+    *value = strtod(start, &after);
+    if (after == start || after > line_end) {
+        return 0;
+    }
+    *p = after;
+    return 1;
+}
+
+static void run_text(Job *job) {
+    FmtSink sink;
+    fmt_sink_init(&sink, job->out);
+
+    const char *p = job->begin;
+    while (p < job->end) {
+        const char *line_end = memchr(p, '\n', (size_t)(job->end - p));
+        if (line_end == NULL) {
+            line_end = job->end;
+        }
+        const char *q = skip_blanks(p, line_end);
+        p = line_end + 1;
+        if (q == line_end || *q == '#') {
+            continue;
+        }
+
+        const char *token = q;
+        while (q < line_end && *q != ' ' && *q != '\t') {
+            q++;
+        }
+        int op = find_operation(token, (size_t)(q - token));
+        double a, b;
+        const char *error;
+        if (op < 0) {
+            error = "unknown operation";
+        } else if (!parse_number(&q, line_end, &a) || !parse_number(&q, line_end, &b)) {
+            error = "expected two numbers";
+        } else if (skip_blanks(q, line_end) != line_end) {
+            error = "extra text after the numbers";
+        } else {
+            error = check_operands(op, b);
+        }
+
+        job->stats.operations++;
+        if (error != NULL) {
+            job->stats.errors++;
+            fmt_str(&sink, "error: ");
+            fmt_str(&sink, error);
+        } else {
+            fmt_double(&sink, operations[op].fn(a, b));
+        }
+        fmt_char(&sink, '\n');
+    }
+    job->ok = fmt_flush(&sink);
+}
+
+// --- Binary ---
+
+static void run_binary(Job *job) {
+    for (size_t i = 0; i < job->count; i++) {
+        BatchRecord r;
+        memcpy(&r, &job->records[i], sizeof(r));
+        int op = r.op < OPERATION_COUNT ? (int)r.op : -1;
+        if (check_operands(op, r.b) != NULL) {
+            job->results[i] = NAN;
+            job->stats.errors++;
+        } else {
+            job->results[i] = operations[op].fn(r.a, r.b);
+        }
+    }
+    job->stats.operations = job->count;
+    job->ok = 1;
+}
+
+static void *job_main(void *arg) {
+    Job *job = arg;
+    if (job->records != NULL) {
+        run_binary(job);
+    } else {
+        run_text(job);
+    }
+    return NULL;
+}
+
+// --- Driver ---
+
+// All of in, NUL-terminated so strtod always stops
+static char *read_all(FILE *in, size_t *len) {
+    size_t cap = READ_CHUNK, used = 0;
+    char *data = malloc(cap + 1);
+    while (data != NULL) {
+        used += fread(data + used, 1, cap - used, in);
+        if (used < cap) {
+            break;
+        }
+        char *bigger = realloc(data, cap * 2 + 1);
+        if (bigger == NULL) {
+            free(data);
+            return NULL;
+        }
+        data = bigger;
+        cap *= 2;
+    }
+    if (data == NULL || ferror(in)) {
+        free(data);
+        return NULL;
+    }
+    data[used] = '\0';
+    *len = used;
+    return data;
+}
+
+static void run_jobs(Job *jobs, int count) {
+    pthread_t tids[BATCH_MAX_THREADS];
+    int started[BATCH_MAX_THREADS];
+    for (int t = 0; t < count; t++) {
+        started[t] = t > 0 && pthread_create(&tids[t], NULL, job_main, &jobs[t]) == 0;
+    }
+    // This thread does job 0, plus any that failed to start
+    for (int t = 0; t < count; t++) {
+        if (!started[t]) {
+            job_main(&jobs[t]);
+        }
+    }
+    for (int t = 1; t < count; t++) {
+        if (started[t]) {
+            pthread_join(tids[t], NULL);
+        }
+    }
+}
+
+int batch_run(FILE *in, FILE *out, int threads, BatchStats *stats) {
+    Job jobs[BATCH_MAX_THREADS];
+    size_t len;
+    char *data = read_all(in, &len);
+    if (data == NULL) {
+        return 0;
+    }
+
+    if (threads < 1) threads = 1;
+    if (threads > BATCH_MAX_THREADS) threads = BATCH_MAX_THREADS;
+    if ((size_t)threads > len / MIN_BYTES_PER_THREAD) {
+        threads = len / MIN_BYTES_PER_THREAD > 0 ? (int)(len / MIN_BYTES_PER_THREAD) : 1;
+    }
+    memset(jobs, 0, sizeof(jobs));
+    int ok = 1;
+
+    if (len >= MAGIC_LEN && memcmp(data, BATCH_MAGIC, MAGIC_LEN) == 0) {
+        size_t count = (len - MAGIC_LEN) / sizeof(BatchRecord);
+        double *results = malloc((count ? count : 1) * sizeof(double));
+        if (results == NULL) {
+            free(data);
+            return 0;
+        }
+        if ((len - MAGIC_LEN) % sizeof(BatchRecord) != 0) {
+            fprintf(stderr, "Warning: ignoring %zu bytes after the last whole record\n",
+                    (len - MAGIC_LEN) % sizeof(BatchRecord));
+        }
+        const BatchRecord *records = (const BatchRecord *)(data + MAGIC_LEN);
+        for (int t = 0; t < threads; t++) {
+            size_t first = count * (size_t)t / (size_t)threads;
+            size_t last = count * (size_t)(t + 1) / (size_t)threads;
+            jobs[t].records = records + first;
+            jobs[t].count = last - first;
+            jobs[t].results = results + first;
+        }
+        run_jobs(jobs, threads);
+        ok = fwrite(results, sizeof(double), count, out) == count;
+        free(results);
+    } else {
+        // Cut at the first newline after each even split point
+        const char *start = data;
+        for (int t = 0; t < threads; t++) {
+            const char *stop = data + len;
+            if (t + 1 < threads) {
+                stop = data + len * (size_t)(t + 1) / (size_t)threads;
+                if (stop < start) stop = start;
+                const char *newline = memchr(stop, '\n', (size_t)(data + len - stop));
+                stop = newline ? newline + 1 : data + len;
+            }
+            jobs[t].begin = start;
+            jobs[t].end = stop;
+            start = stop;
+            // One thread writes straight out; several each fill a buffer
+            jobs[t].out = threads == 1 ? out : open_memstream(&jobs[t].text, &jobs[t].text_len);
+            if (jobs[t].out == NULL) {
+                ok = 0;
+                jobs[t].end = jobs[t].begin;
+                jobs[t].out = out;
+            }
+        }
+        run_jobs(jobs, threads);
+        for (int t = 0; t < threads; t++) {
+            ok = ok && jobs[t].ok;
+            if (jobs[t].out != out) {
+                fclose(jobs[t].out);
+                ok = ok && fwrite(jobs[t].text, 1, jobs[t].text_len, out) == jobs[t].text_len;
+                free(jobs[t].text);
+            }
+        }
+    }
+
+    stats->operations = 0;
+    stats->errors = 0;
+    for (int t = 0; t < threads; t++) {
+        stats->operations += jobs[t].stats.operations;
+        stats->errors += jobs[t].stats.errors;
+    }
+    free(data);
+    return ok && fflush(out) == 0;
+}
@@ -0,0 +1,50 @@
+/*
+ * batch.h - Non-interactive calculator header
+ * Exercise 10.1: Multi-file Calculator
+ *
+ * Runs a whole file of operations instead of asking for each one.
+ *
+ * Text input, one operation per line (blank lines and # comments are
+ * skipped):
+ *     + 5 3          or    add 5 3
+ *     / 1 0          or    div 1 0
+ * Output has one line per operation: the result, printed like Python's
+ * repr(float), or "error: <reason>".
+ *
+ * Binary input starts with the 8 bytes BATCH_MAGIC followed by
+ * BatchRecords in the machine's byte order. Output is one double per
+ * record, NAN where the text form would say "error". From Python:
+ *     f.write(b"CALCOPS1")
+ *     f.write(struct.pack("=IIdd", op, 0, a, b))   # op: index into operations
+ *
+ * Large inputs are split between threads; the output order always
+ * matches the input.
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define BATCH_MAGIC "CALCOPS1"
+#define BATCH_MAX_THREADS 64
+
+typedef struct {
+    uint32_t op;        // Index into operations[] (see operations.h)
+    uint32_t reserved;  // 0
+    double a;
+    double b;
+} BatchRecord;
+
+typedef struct {
+    size_t operations;
+    size_t errors;
+} BatchStats;
+
+// Reads all of in, writes results to out. Returns 1 on success, 0 if
+// the input could not be read or output could not be written.
+int batch_run(FILE *in, FILE *out, int threads, BatchStats *stats);
+
+#endif /* BATCH_H */
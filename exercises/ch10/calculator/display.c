@@ -5,6 +5,7 @@
 
 #include <stdio.h>
 #include "display.h"
+#include "../../common/fastfmt.h"
 
 void display_welcome(void) {
     printf("================================\n");
@@ -12,9 +13,30 @@ void display_welcome(void) {
     printf("================================\n\n");
 }
 
+// Example: "5.00 + 3.00 = 8.00"
 void display_result(const char *operation, double a, double b, double result) {
-    // TODO: Implement formatted output
-    // Example: "5.00 + 3.00 = 8.00"
+    FmtSink out;
+    fmt_sink_init(&out, stdout);
+    fmt_fixed(&out, a, 2);
+    fmt_char(&out, ' ');
+    fmt_str(&out, operation);
+    fmt_char(&out, ' ');
+    fmt_fixed(&out, b, 2);
+    fmt_str(&out, " = ");
+    fmt_fixed(&out, result, 2);
+    fmt_char(&out, '\n');
+    fmt_flush(&out);
+}
+
+// Example: "(a + b) ^ 3 / c = 9.00"
+void display_expression_result(const char *expression, double result) {
+    FmtSink out;
+    fmt_sink_init(&out, stdout);
+    fmt_str(&out, expression);
+    fmt_str(&out, " = ");
+    fmt_fixed(&out, result, 2);
+    fmt_char(&out, '\n');
+    fmt_flush(&out);
 }
 
 void display_error(const char *message) {
@@ -28,6 +50,7 @@ void display_menu(void) {
     printf("  3. Multiply\n");
     printf("  4. Divide\n");
     printf("  5. Power\n");
+    printf("  6. Expression\n");
     printf("  0. Exit\n");
     printf("\nChoice: ");
 }
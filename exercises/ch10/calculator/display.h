@@ -9,6 +9,7 @@
 // Function declarations
 void display_welcome(void);
 void display_result(const char *operation, double a, double b, double result);
+void display_expression_result(const char *expression, double result);
 void display_error(const char *message);
 void display_menu(void);
 
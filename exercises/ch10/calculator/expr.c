@@ -0,0 +1,516 @@
+/*
+ * expr.c - Expression compiler and evaluator implementation
+ * Exercise 10.1: Multi-file Calculator
+ *
+ * Compiling is a Pratt parser: each operator has a binding power, and
+ * parse_expression keeps absorbing operators that bind at least as
+ * tightly as the one that called it. Instead of building a tree it
+ * writes stack-machine code as it goes:
+ *
+ *   (a + b) ^ 3 / c   ->   VAR a, ADD_VAR b, POW_CONST 3, DIV_VAR c
+ *
+ * Loading a variable or constant straight into an operator is so
+ * common that those pairs get their own "fused" instructions (ADD_VAR
+ * above), which halves the number of steps the evaluator takes.
+ *
+ * Every parse step returns where its code starts and whether its value
+ * is a constant. When both sides of an operator are constants, their
+ * code is the last thing written, so it is cut off again (along with any
+ * constants it added to the pool) and replaced by one CONST holding the
+ * answer.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "expr.h"
+
+#define EXPR_BLOCK 128   // Rows per pass in expr_eval_rows
+#define MAX_NESTING 64   // Parentheses and operators inside each other
+
+// Arithmetic operators come in three forms, in this order:
+//   OP_ADD           both operands on the stack
+//   OP_ADD_CONST k   right operand is consts[k]
+//   OP_ADD_VAR v     right operand is variable v
+enum {
+    OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_MOD, OP_POW,
+    OP_ADD_CONST, OP_SUB_CONST, OP_MUL_CONST, OP_DIV_CONST, OP_MOD_CONST, OP_POW_CONST,
+    OP_ADD_VAR, OP_SUB_VAR, OP_MUL_VAR, OP_DIV_VAR, OP_MOD_VAR, OP_POW_VAR,
+    OP_CONST,   // k: push consts[k]
+    OP_VAR,     // v: push vars[v]
+    OP_NEG,
+    OP_CALL     // f: apply functions[f] to the top of the stack
+};
+
+#define ARITH_COUNT 6
+
+typedef struct {
+    const char *name;
+    double (*fn)(double);
+} Function;
+
+static const Function functions[] = {
+    {"sqrt", sqrt}, {"abs", fabs}, {"exp", exp}, {"log", log},
+    {"sin", sin}, {"cos", cos}, {"tan", tan},
+};
+
+#define FUNCTION_COUNT (int)(sizeof(functions) / sizeof(functions[0]))
+
+static const char op_symbols[ARITH_COUNT] = {'+', '-', '*', '/', '%', '^'};
+
+// --- Shared arithmetic ---
+
+static inline double arith(int op, double x, double y) {
+    switch (op) {
+    case OP_ADD: return x + y;
+    case OP_SUB: return x - y;
+    case OP_MUL: return x * y;
+    case OP_DIV: return x / y;
+    case OP_MOD: return fmod(x, y);
+    default:     return pow(x, y);
+    }
+}
+
+// --- Compiler ---
+
+typedef struct {
+    Expr *e;
+    const char *text;
+    const char *pos;
+    int nesting;     // parse_expression calls in progress
+} Parser;
+
+typedef struct {
+    size_t start;    // Where this operand's code begins
+    int const_count; // Size of the constant pool at that point
+    int is_const;
+    double value;    // If is_const
+} Operand;
+
+static int fail(Parser *p, const char *message) {
+    // Keep the first error; later ones are usually consequences of it
+    if (p->e->error[0] == '\0') {
+        strncpy(p->e->error, message, sizeof(p->e->error) - 1);
+        p->e->error_pos = (size_t)(p->pos - p->text);
+    }
+    return 0;
+}
+
+static char peek(Parser *p) {
+    while (*p->pos == ' ' || *p->pos == '\t') {
+        p->pos++;
+    }
+    return *p->pos;
+}
+
+static int emit(Parser *p, int op, int operand) {
+    Expr *e = p->e;
+    if (e->code_len + 2 > EXPR_MAX_CODE) {
+        return fail(p, "expression too long");
+    }
+    e->code[e->code_len++] = (unsigned char)op;
+    if (operand >= 0) {
+        e->code[e->code_len++] = (unsigned char)operand;
+    }
+    return 1;
+}
+
+static int emit_const(Parser *p, double value) {
+    Expr *e = p->e;
+    int k = 0;
+    while (k < e->const_count && memcmp(&e->consts[k], &value, sizeof(value)) != 0) {
+        k++;
+    }
+    if (k == e->const_count) {
+        if (k == EXPR_MAX_CONSTS) {
+            return fail(p, "too many constants");
+        }
+        e->consts[e->const_count++] = value;
+    }
+    return emit(p, OP_CONST, k);
+}
+
+// Replace everything written since operand began with one CONST
+static int fold_to_const(Parser *p, const Operand *operand, double value) {
+    p->e->code_len = operand->start;
+    p->e->const_count = operand->const_count;
+    return emit_const(p, value);
+}
+
+static int var_slot(Parser *p, const char *name) {
+    Expr *e = p->e;
+    int v = expr_var_index(e, name);
+    if (v < 0) {
+        if (e->var_count == EXPR_MAX_VARS) {
+            return fail(p, "too many variables") - 1;
+        }
+        v = e->var_count++;
+        strcpy(e->vars[v], name);
+    }
+    return v;
+}
+
+// Combine lhs and rhs (whose code has just been written) with op
+static int emit_binary(Parser *p, int op, Operand *lhs, const Operand *rhs) {
+    Expr *e = p->e;
+    if (lhs->is_const && rhs->is_const) {
+        lhs->value = arith(op, lhs->value, rhs->value);
+        return fold_to_const(p, lhs, lhs->value);
+    }
+    lhs->is_const = 0;
+    // A right operand that is a single load fuses into the operator
+    if (rhs->start + 2 == e->code_len) {
+        int load = e->code[rhs->start];
+        if (load == OP_CONST || load == OP_VAR) {
+            int operand = e->code[rhs->start + 1];
+            e->code_len = rhs->start;
+            return emit(p, op + (load == OP_CONST ? OP_ADD_CONST : OP_ADD_VAR), operand);
+        }
+    }
+    return emit(p, op, -1);
+}
+
+static int parse_expression(Parser *p, int min_power, Operand *out);
+
+// Binding powers: left power decides whether the operator is absorbed,
+// right power is passed down for its right operand. ^ has right < left
+// so 2 ^ 3 ^ 2 groups as 2 ^ (3 ^ 2), like Python's **.
+#define PREFIX_POWER 5
+
+static int infix_power(char c, int *op, int *left, int *right) {
+    switch (c) {
+    case '+': *op = OP_ADD; *left = 1; *right = 2; return 1;
+    case '-': *op = OP_SUB; *left = 1; *right = 2; return 1;
+    case '*': *op = OP_MUL; *left = 3; *right = 4; return 1;
+    case '/': *op = OP_DIV; *left = 3; *right = 4; return 1;
+    case '%': *op = OP_MOD; *left = 3; *right = 4; return 1;
+    case '^': *op = OP_POW; *left = 6; *right = 5; return 1;
+    default:  return 0;
+    }
+}
+
+static int parse_prefix(Parser *p, Operand *out) {
+    char c = peek(p);
+    out->start = p->e->code_len;
+    out->const_count = p->e->const_count;
+    out->is_const = 0;
+
+    if ((c >= '0' && c <= '9') || c == '.') {
+        char *end;
+        out->value = strtod(p->pos, &end);
+        if (end == p->pos) {
+            return fail(p, "bad number");
+        }
+        p->pos = end;
+        out->is_const = 1;
+        return emit_const(p, out->value);
+    }
+
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_') {
+        char name[EXPR_NAME_MAX];
+        size_t len = 0;
+        const char *start = p->pos;
+        while ((*p->pos >= 'a' && *p->pos <= 'z') || (*p->pos >= 'A' && *p->pos <= 'Z')
+               || (*p->pos >= '0' && *p->pos <= '9') || *p->pos == '_') {
+            if (len + 1 == EXPR_NAME_MAX) {
+                p->pos = start;
+                return fail(p, "name too long");
+            }
+            name[len++] = *p->pos++;
+        }
+        name[len] = '\0';
+
+        if (peek(p) != '(') {
+            int v = var_slot(p, name);
+            return v >= 0 && emit(p, OP_VAR, v);
+        }
+
+        int f = 0;
+        while (f < FUNCTION_COUNT && strcmp(functions[f].name, name) != 0) {
+            f++;
+        }
+        if (f == FUNCTION_COUNT) {
+            p->pos = start;
+            return fail(p, "unknown function");
+        }
+        p->pos++;
+        if (!parse_expression(p, 0, out)) {
+            return 0;
+        }
+        if (peek(p) != ')') {
+            return fail(p, "expected ')'");
+        }
+        p->pos++;
+        if (out->is_const) {
+            out->value = functions[f].fn(out->value);
+            return fold_to_const(p, out, out->value);
+        }
+        return emit(p, OP_CALL, f);
+    }
+
+    if (c == '(') {
+        p->pos++;
+        if (!parse_expression(p, 0, out)) {
+            return 0;
+        }
+        if (peek(p) != ')') {
+            return fail(p, "expected ')'");
+        }
+        p->pos++;
+        return 1;
+    }
+
+    if (c == '-' || c == '+') {
+        p->pos++;
+        if (!parse_expression(p, PREFIX_POWER, out)) {
+            return 0;
+        }
+        if (c == '+') {
+            return 1;
+        }
+        if (out->is_const) {
+            out->value = -out->value;
+            return fold_to_const(p, out, out->value);
+        }
+        return emit(p, OP_NEG, -1);
+    }
+
+    return fail(p, c == '\0' ? "unexpected end of expression"
+                             : "expected a number, name or '('");
+}
+
+static int parse_expression(Parser *p, int min_power, Operand *out) {
+    if (++p->nesting > MAX_NESTING) {
+        return fail(p, "expression nested too deeply");
+    }
+    if (!parse_prefix(p, out)) {
+        return 0;
+    }
+    int op, left, right;
+    while (infix_power(peek(p), &op, &left, &right) && left >= min_power) {
+        p->pos++;
+        Operand rhs;
+        if (!parse_expression(p, right, &rhs) || !emit_binary(p, op, out, &rhs)) {
+            return 0;
+        }
+    }
+    p->nesting--;
+    return 1;
+}
+
+// Deepest the stack gets while running the code
+static int stack_needed(const Expr *e) {
+    int depth = 0, deepest = 0;
+    for (size_t pc = 0; pc < e->code_len; pc++) {
+        int op = e->code[pc];
+        if (op == OP_CONST || op == OP_VAR) {
+            depth++;
+        } else if (op < OP_ADD_CONST) {
+            depth--;
+        }
+        if (op >= OP_ADD_CONST && op != OP_NEG) {
+            pc++;   // Skip the operand byte
+        }
+        if (depth > deepest) {
+            deepest = depth;
+        }
+    }
+    return deepest;
+}
+
+int expr_compile(Expr *e, const char *text) {
+    Parser p = {e, text, text, 0};
+    Operand result;
+
+    e->code_len = 0;
+    e->const_count = 0;
+    e->var_count = 0;
+    e->error[0] = '\0';
+    e->error_pos = 0;
+
+    if (!parse_expression(&p, 0, &result)) {
+        return 0;
+    }
+    if (peek(&p) != '\0') {
+        return fail(&p, *p.pos == ')' ? "unmatched ')'" : "expected an operator");
+    }
+    e->max_stack = stack_needed(e);
+    if (e->max_stack > EXPR_MAX_STACK) {
+        p.pos = text;
+        return fail(&p, "expression nested too deeply");
+    }
+    return 1;
+}
+
+int expr_var_index(const Expr *e, const char *name) {
+    for (int v = 0; v < e->var_count; v++) {
+        if (strcmp(e->vars[v], name) == 0) {
+            return v;
+        }
+    }
+    return -1;
+}
+
+// --- Evaluation ---
+
+double expr_eval(const Expr *e, const double *vars) {
+    double stack[EXPR_MAX_STACK];
+    double *top = stack - 1;   // Points at the top value
+    const unsigned char *pc = e->code;
+    const unsigned char *end = pc + e->code_len;
+
+    while (pc < end) {
+        int op = *pc++;
+        switch (op) {
+        case OP_CONST:
+            *++top = e->consts[*pc++];
+            break;
+        case OP_VAR:
+            *++top = vars[*pc++];
+            break;
+        case OP_NEG:
+            *top = -*top;
+            break;
+        case OP_CALL:
+            *top = functions[*pc++].fn(*top);
+            break;
+        case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV: case OP_MOD: case OP_POW:
+            top--;
+            *top = arith(op, top[0], top[1]);
+            break;
+        case OP_ADD_CONST: case OP_SUB_CONST: case OP_MUL_CONST:
+        case OP_DIV_CONST: case OP_MOD_CONST: case OP_POW_CONST:
+            *top = arith(op - OP_ADD_CONST, *top, e->consts[*pc++]);
+            break;
+        default:
+            *top = arith(op - OP_ADD_VAR, *top, vars[*pc++]);
+            break;
+        }
+    }
+    return *top;
+}
+
+// x[i] = x[i] op y[i] for a block; one loop per operator so the
+// compiler can vectorize each
+static void block_arith(int op, double *x, const double *y, size_t n) {
+    switch (op) {
+    case OP_ADD:
+        for (size_t i = 0; i < n; i++) x[i] += y[i];
+        break;
+    case OP_SUB:
+        for (size_t i = 0; i < n; i++) x[i] -= y[i];
+        break;
+    case OP_MUL:
+        for (size_t i = 0; i < n; i++) x[i] *= y[i];
+        break;
+    case OP_DIV:
+        for (size_t i = 0; i < n; i++) x[i] /= y[i];
+        break;
+    case OP_MOD:
+        for (size_t i = 0; i < n; i++) x[i] = fmod(x[i], y[i]);
+        break;
+    default:
+        for (size_t i = 0; i < n; i++) x[i] = pow(x[i], y[i]);
+        break;
+    }
+}
+
+static void block_arith_const(int op, double *x, double y, size_t n) {
+    switch (op) {
+    case OP_ADD:
+        for (size_t i = 0; i < n; i++) x[i] += y;
+        break;
+    case OP_SUB:
+        for (size_t i = 0; i < n; i++) x[i] -= y;
+        break;
+    case OP_MUL:
+        for (size_t i = 0; i < n; i++) x[i] *= y;
+        break;
+    case OP_DIV:
+        for (size_t i = 0; i < n; i++) x[i] /= y;
+        break;
+    case OP_MOD:
+        for (size_t i = 0; i < n; i++) x[i] = fmod(x[i], y);
+        break;
+    default:
+        for (size_t i = 0; i < n; i++) x[i] = pow(x[i], y);
+        break;
+    }
+}
+
+void expr_eval_rows(const Expr *e, const double *const *columns, size_t rows, double *out) {
+    double stack[EXPR_MAX_STACK][EXPR_BLOCK];
+
+    for (size_t first = 0; first < rows; first += EXPR_BLOCK) {
+        size_t n = rows - first < EXPR_BLOCK ? rows - first : EXPR_BLOCK;
+        const unsigned char *pc = e->code;
+        const unsigned char *end = pc + e->code_len;
+        int top = -1;
+
+        while (pc < end) {
+            int op = *pc++;
+            switch (op) {
+            case OP_CONST: {
+                double k = e->consts[*pc++];
+                top++;
+                for (size_t i = 0; i < n; i++) stack[top][i] = k;
+                break;
+            }
+            case OP_VAR:
+                top++;
+                memcpy(stack[top], columns[*pc++] + first, n * sizeof(double));
+                break;
+            case OP_NEG:
+                for (size_t i = 0; i < n; i++) stack[top][i] = -stack[top][i];
+                break;
+            case OP_CALL: {
+                double (*fn)(double) = functions[*pc++].fn;
+                for (size_t i = 0; i < n; i++) stack[top][i] = fn(stack[top][i]);
+                break;
+            }
+            case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV: case OP_MOD: case OP_POW:
+                top--;
+                block_arith(op, stack[top], stack[top + 1], n);
+                break;
+            case OP_ADD_CONST: case OP_SUB_CONST: case OP_MUL_CONST:
+            case OP_DIV_CONST: case OP_MOD_CONST: case OP_POW_CONST:
+                block_arith_const(op - OP_ADD_CONST, stack[top], e->consts[*pc++], n);
+                break;
+            default:
+                block_arith(op - OP_ADD_VAR, stack[top], columns[*pc++] + first, n);
+                break;
+            }
+        }
+        memcpy(out + first, stack[0], n * sizeof(double));
+    }
+}
+
+// --- Listing ---
+
+void expr_print_code(const Expr *e, FILE *out) {
+    static const char *const forms[] = {"", "_CONST", "_VAR"};
+    static const char *const names[ARITH_COUNT] = {"ADD", "SUB", "MUL", "DIV", "MOD", "POW"};
+
+    for (size_t pc = 0; pc < e->code_len; pc++) {
+        int op = e->code[pc];
+        fprintf(out, "  %3zu  ", pc);
+        if (op == OP_CONST) {
+            fprintf(out, "CONST %.17g\n", e->consts[e->code[++pc]]);
+        } else if (op == OP_VAR) {
+            fprintf(out, "VAR %s\n", e->vars[e->code[++pc]]);
+        } else if (op == OP_NEG) {
+            fprintf(out, "NEG\n");
+        } else if (op == OP_CALL) {
+            fprintf(out, "CALL %s\n", functions[e->code[++pc]].name);
+        } else {
+            int form = op / ARITH_COUNT;
+            fprintf(out, "%s%s", names[op % ARITH_COUNT], forms[form]);
+            if (form == 1) {
+                fprintf(out, " %.17g", e->consts[e->code[++pc]]);
+            } else if (form == 2) {
+                fprintf(out, " %s", e->vars[e->code[++pc]]);
+            }
+            fprintf(out, "   (%c)\n", op_symbols[op % ARITH_COUNT]);
+        }
+    }
+}
@@ -0,0 +1,63 @@
+/*
+ * expr.h - Expression compiler and evaluator header
+ * Exercise 10.1: Multi-file Calculator
+ *
+ * Turns text like "(a + b) ^ 3 / c" into a short list of bytecode
+ * instructions once, then runs that list as often as you like with
+ * different variable values - Python's compile() and eval() split:
+ *
+ *   code = compile("(a + b) ** 3 / c", "<expr>", "eval")
+ *   for row in rows:
+ *       eval(code, {"a": row[0], "b": row[1], "c": row[2]})
+ *
+ * Supported: numbers, variable names, + - * / % ^ (power, right to
+ * left), unary minus, parentheses, and sqrt abs exp log sin cos tan.
+ * % is C's fmod: the remainder takes the sign of the left side.
+ * Parts that do not depend on variables, like "2 * 3.14159 / 360", are
+ * worked out at compile time. Arithmetic follows IEEE doubles, so
+ * dividing by zero gives inf or nan rather than an error.
+ */
+
+#ifndef EXPR_H
+#define EXPR_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+#define EXPR_MAX_CODE 512     // Bytes of bytecode
+#define EXPR_MAX_CONSTS 64
+#define EXPR_MAX_VARS 16
+#define EXPR_MAX_STACK 32
+#define EXPR_NAME_MAX 16      // Including the '\0'
+
+typedef struct {
+    unsigned char code[EXPR_MAX_CODE];
+    size_t code_len;
+    double consts[EXPR_MAX_CONSTS];
+    int const_count;
+    char vars[EXPR_MAX_VARS][EXPR_NAME_MAX];  // In order of first use
+    int var_count;
+    int max_stack;
+    char error[64];      // Set when expr_compile fails
+    size_t error_pos;    // Offset into the text where it went wrong
+} Expr;
+
+// Returns 1 on success, 0 on a syntax error (see e->error)
+int expr_compile(Expr *e, const char *text);
+
+// Slot of a variable in the values array, or -1 if the expression
+// does not use it
+int expr_var_index(const Expr *e, const char *name);
+
+// vars[i] is the value of e->vars[i]
+double expr_eval(const Expr *e, const double *vars);
+
+// out[r] = the expression with variable i taken from columns[i][r].
+// Runs each instruction over a block of rows at a time, so the cost of
+// decoding the bytecode is shared by the whole block.
+void expr_eval_rows(const Expr *e, const double *const *columns, size_t rows, double *out);
+
+// One instruction per line, for seeing what the compiler produced
+void expr_print_code(const Expr *e, FILE *out);
+
+#endif /* EXPR_H */
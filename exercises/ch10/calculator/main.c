@@ -4,14 +4,43 @@
  *
  * Build: make
  * Run:   ./calculator
+ *        ./calculator -e "(a + b) ^ 3 / c" a=1 b=2 c=3
+ *        ./calculator -e "(a + b) ^ 3 / c" -l -t 10000000
+ *        ./calculator -f ops.txt -j 4 -o results.txt
+ *        ./calculator -b 1000000
  * Clean: make clean
+ *
+ * Options: -e EXPR   evaluate EXPR with the name=value arguments
+ *          -l        also list the compiled bytecode
+ *          -t ROWS   time EXPR over ROWS rows of random values
+ *          -f FILE   run a file of operations, "-" for stdin (see batch.h)
+ *          -j N      split a large -f input across N threads
+ *          -o FILE   write -f results to FILE instead of stdout
+ *          -b N      time the array versions of the operations on N values
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "batch.h"
 #include "operations.h"
 #include "display.h"
+#include "expr.h"
+
+// Function prototypes
+int run_command_line(int argc, char *argv[]);
+int run_batch(const char *in_path, const char *out_path, int threads);
+void evaluate_interactive(void);
+int compile_or_report(Expr *e, const char *text);
+void time_expression(const Expr *e, size_t rows);
+int time_operations(size_t n);
+
+int main(int argc, char *argv[]) {
+    if (argc > 1) {
+        return run_command_line(argc, argv);
+    }
 
-int main(void) {
     display_welcome();
 
     int choice;
@@ -32,37 +61,315 @@ int main(void) {
             break;
         }
 
-        if (choice < 1 || choice > 5) {
+        if (choice < 1 || choice > 6) {
             display_error("Invalid choice");
             continue;
         }
 
+        if (choice == 6) {
+            evaluate_interactive();
+            continue;
+        }
+
         printf("Enter first number: ");
         scanf("%lf", &a);
 
         printf("Enter second number: ");
         scanf("%lf", &b);
 
-        // TODO: Call appropriate operation and display result
-        switch (choice) {
-            case 1:
-                result = op_add(a, b);
-                display_result("+", a, b, result);
-                break;
-            case 2:
-                // Implement
-                break;
-            case 3:
-                // Implement
-                break;
-            case 4:
-                // Implement (check for division by zero)
-                break;
-            case 5:
-                // Implement
-                break;
+        // Menu choices are numbered in table order
+        const Operation *op = &operations[choice - 1];
+        if (choice - 1 == OPERATION_DIVIDE && b == 0) {
+            display_error("Division by zero");
+            continue;
         }
+        result = op->fn(a, b);
+        char symbol[2] = {op->symbol, '\0'};
+        display_result(symbol, a, b, result);
     }
 
     return 0;
 }
+
+// --- Expressions ---
+
+int compile_or_report(Expr *e, const char *text) {
+    if (expr_compile(e, text)) {
+        return 1;
+    }
+    char message[128];
+    snprintf(message, sizeof(message), "%s at column %zu", e->error, e->error_pos + 1);
+    display_error(message);
+    return 0;
+}
+
+void evaluate_interactive(void) {
+    char line[256];
+    Expr e;
+    double values[EXPR_MAX_VARS];
+
+    // Drop the rest of the menu choice line
+    int c;
+    while ((c = getchar()) != '\n' && c != EOF);
+
+    printf("Enter expression: ");
+    if (fgets(line, sizeof(line), stdin) == NULL) {
+        return;
+    }
+    line[strcspn(line, "\n")] = '\0';
+    if (!compile_or_report(&e, line)) {
+        return;
+    }
+
+    for (int v = 0; v < e.var_count; v++) {
+        printf("Value of %s: ", e.vars[v]);
+        if (scanf("%lf", &values[v]) != 1) {
+            while ((c = getchar()) != '\n' && c != EOF);
+            display_error("Invalid number");
+            return;
+        }
+    }
+    display_expression_result(line, expr_eval(&e, values));
+}
+
+int run_command_line(int argc, char *argv[]) {
+    const char *text = NULL;
+    const char *in_path = NULL;
+    const char *out_path = NULL;
+    int threads = 1;
+    int list = 0;
+    size_t rows = 0;
+    double values[EXPR_MAX_VARS] = {0};
+    Expr e;
+
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; i++) {
+        if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            text = argv[++i];
+        } else if (strcmp(argv[i], "-l") == 0) {
+            list = 1;
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            rows = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            in_path = argv[++i];
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            return time_operations(strtoull(argv[++i], NULL, 10)) ? 0 : 1;
+        } else {
+            break;
+        }
+    }
+    if (in_path != NULL) {
+        return run_batch(in_path, out_path, threads);
+    }
+    if (text == NULL) {
+        fprintf(stderr, "Usage: %s -e EXPR [-l] [-t ROWS] [name=value ...]\n"
+                        "       %s -f FILE [-j THREADS] [-o FILE]\n"
+                        "       %s -b N\n", argv[0], argv[0], argv[0]);
+        return 1;
+    }
+    if (!compile_or_report(&e, text)) {
+        return 1;
+    }
+
+    // Remaining arguments: name=value
+    for (; i < argc; i++) {
+        char *equals = strchr(argv[i], '=');
+        if (equals == NULL) {
+            fprintf(stderr, "Expected name=value, got '%s'\n", argv[i]);
+            return 1;
+        }
+        *equals = '\0';
+        int v = expr_var_index(&e, argv[i]);
+        if (v < 0) {
+            fprintf(stderr, "Warning: '%s' is not used by the expression\n", argv[i]);
+            continue;
+        }
+        values[v] = strtod(equals + 1, NULL);
+    }
+
+    if (list) {
+        printf("Bytecode (%zu bytes, stack depth %d):\n", e.code_len, e.max_stack);
+        expr_print_code(&e, stdout);
+    }
+    if (rows > 0) {
+        time_expression(&e, rows);
+    } else {
+        display_expression_result(text, expr_eval(&e, values));
+    }
+    return 0;
+}
+
+// --- Batch mode ---
+
+static double seconds_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int run_batch(const char *in_path, const char *out_path, int threads) {
+    FILE *in = strcmp(in_path, "-") == 0 ? stdin : fopen(in_path, "rb");
+    if (in == NULL) {
+        perror(in_path);
+        return 1;
+    }
+    FILE *out = out_path == NULL ? stdout : fopen(out_path, "wb");
+    if (out == NULL) {
+        perror(out_path);
+        return 1;
+    }
+
+    BatchStats stats;
+    double start = seconds_now();
+    int ok = batch_run(in, out, threads, &stats);
+    double seconds = seconds_now() - start;
+
+    if (in != stdin) fclose(in);
+    if (out != stdout && fclose(out) != 0) ok = 0;
+    if (!ok) {
+        display_error("Batch failed (read, write or out of memory)");
+        return 1;
+    }
+    fprintf(stderr, "%zu operations, %zu errors, %.1f Mops/s\n", stats.operations,
+            stats.errors, stats.operations / (seconds > 0 ? seconds : 1e-9) / 1e6);
+    return stats.errors > 0 ? 2 : 0;
+}
+
+// --- Timing ---
+
+// Compile once, run over many rows: one row at a time with expr_eval,
+// then a block of rows per instruction with expr_eval_rows
+void time_expression(const Expr *e, size_t rows) {
+    double *columns[EXPR_MAX_VARS];
+    double *out_single = malloc(rows * sizeof(double));
+    double *out_rows = malloc(rows * sizeof(double));
+    double row[EXPR_MAX_VARS];
+    int ok = out_single != NULL && out_rows != NULL;
+
+    for (int v = 0; v < e->var_count; v++) {
+        columns[v] = malloc(rows * sizeof(double));
+        ok = ok && columns[v] != NULL;
+    }
+    if (!ok) {
+        display_error("Out of memory");
+        for (int v = 0; v < e->var_count; v++) {
+            free(columns[v]);
+        }
+        free(out_single);
+        free(out_rows);
+        return;
+    }
+    srand(42);
+    for (int v = 0; v < e->var_count; v++) {
+        for (size_t r = 0; r < rows; r++) {
+            columns[v][r] = 1.0 + (double)rand() / RAND_MAX;
+        }
+    }
+
+    clock_t start = clock();
+    for (size_t r = 0; r < rows; r++) {
+        for (int v = 0; v < e->var_count; v++) {
+            row[v] = columns[v][r];
+        }
+        out_single[r] = expr_eval(e, row);
+    }
+    double single_s = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    expr_eval_rows(e, (const double *const *)columns, rows, out_rows);
+    double rows_s = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    size_t mismatches = 0;
+    for (size_t r = 0; r < rows; r++) {
+        // Same operations in the same order, so the results are identical
+        mismatches += memcmp(&out_single[r], &out_rows[r], sizeof(double)) != 0;
+    }
+
+    printf("%zu rows, %d variable(s)\n", rows, e->var_count);
+    printf("  expr_eval per row: %8.1f Mrows/s\n", rows / (single_s > 0 ? single_s : 1e-9) / 1e6);
+    printf("  expr_eval_rows:    %8.1f Mrows/s\n", rows / (rows_s > 0 ? rows_s : 1e-9) / 1e6);
+    printf("  results differ in %zu rows\n", mismatches);
+
+    for (int v = 0; v < e->var_count; v++) {
+        free(columns[v]);
+    }
+    free(out_single);
+    free(out_rows);
+}
+
+// Each operation over n values: one call per element through the
+// table's function pointer, then the array version. Results must match
+// bit for bit. Returns 1 on success, 0 if n is 0 or memory runs out.
+int time_operations(size_t n) {
+    if (n == 0) {
+        display_error("Need at least one value to time");
+        return 0;
+    }
+    double *a = malloc(n * sizeof(double));
+    double *b = malloc(n * sizeof(double));
+    double *expected = malloc(n * sizeof(double));
+    double *out = malloc(n * sizeof(double));
+    uint64_t *zero_mask = malloc((n / 64 + 1) * sizeof(uint64_t));
+    if (a == NULL || b == NULL || expected == NULL || out == NULL || zero_mask == NULL) {
+        display_error("Out of memory");
+        free(a);
+        free(b);
+        free(expected);
+        free(out);
+        free(zero_mask);
+        return 0;
+    }
+
+    printf("%-10s %14s %14s %8s\n", "operation", "per call M/s", "batch M/s", "match");
+    for (int k = 0; k < OPERATION_COUNT; k++) {
+        // Whole-number exponents for power (with a few fractional ones),
+        // and an occasional zero divisor
+        srand(42);
+        for (size_t i = 0; i < n; i++) {
+            a[i] = (double)rand() / RAND_MAX * 4 - 2;
+            if (k == OPERATION_POWER) {
+                b[i] = rand() % 32 == 0 ? 0.5 : (double)(rand() % 41 - 20);
+            } else {
+                b[i] = rand() % 1000 == 0 ? 0.0 : (double)rand() / RAND_MAX * 4 - 2;
+            }
+        }
+
+        double start = seconds_now();
+        BinaryOp fn = operations[k].fn;
+        for (size_t i = 0; i < n; i++) {
+            expected[i] = fn(a[i], b[i]);
+        }
+        double call_s = seconds_now() - start;
+
+        size_t zeros = 0;
+        start = seconds_now();
+        switch (k) {
+        case 0: op_add_batch(out, a, b, n); break;
+        case 1: op_subtract_batch(out, a, b, n); break;
+        case 2: op_multiply_batch(out, a, b, n); break;
+        case 3: zeros = op_divide_batch(out, a, b, n, zero_mask); break;
+        default: op_power_batch(out, a, b, n); break;
+        }
+        double batch_s = seconds_now() - start;
+
+        int match = memcmp(out, expected, n * sizeof(double)) == 0;
+        printf("%-10s %14.1f %14.1f %8s", operations[k].name,
+               n / (call_s > 0 ? call_s : 1e-9) / 1e6,
+               n / (batch_s > 0 ? batch_s : 1e-9) / 1e6, match ? "yes" : "NO");
+        if (k == OPERATION_DIVIDE) {
+            printf("   (%zu zero divisors flagged)", zeros);
+        }
+        printf("\n");
+    }
+
+    free(a);
+    free(b);
+    free(expected);
+    free(out);
+    free(zero_mask);
+    return 1;
+}
@@ -1,34 +1,231 @@
 /*
  * operations.c - Math operations implementation
  * Exercise 10.1: Multi-file Calculator
+ *
+ * The _batch versions do two elements per SSE2 instruction on x86
+ * (plain loops elsewhere) and give exactly the same results as calling
+ * the single-value functions one element at a time.
  */
 
+#include <math.h>
+#include <string.h>
 #include "operations.h"
 
-// TODO: Implement all operations
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 double op_add(double a, double b) {
     return a + b;
 }
 
 double op_subtract(double a, double b) {
-    // Your implementation
-    return 0;
+    return a - b;
 }
 
 double op_multiply(double a, double b) {
-    // Your implementation
-    return 0;
+    return a * b;
 }
 
 double op_divide(double a, double b) {
-    // Your implementation
-    // Handle division by zero!
-    return 0;
+    // No sensible answer; NAN makes any later arithmetic NAN too
+    if (b == 0) {
+        return NAN;
+    }
+    return a / b;
+}
+
+// base^n for n >= 0 by squaring: walk the bits of n, squaring base at
+// each step and multiplying it in where the bit is 1.
+//   x^13 = x^8 * x^4 * x^1   (13 = 0b1101): 6 multiplies, not 12
+static double power_unsigned(double base, unsigned int n) {
+    double result = 1.0;
+    while (n != 0) {
+        if (n & 1) {
+            result *= base;
+        }
+        base *= base;
+        n >>= 1;
+    }
+    return result;
 }
 
 double op_power(double base, int exp) {
-    // Your implementation
-    // Handle negative exponents
-    return 0;
+    // Negate in unsigned so INT_MIN works too
+    unsigned int n = exp < 0 ? 0u - (unsigned int)exp : (unsigned int)exp;
+    double result = power_unsigned(base, n);
+    if (exp >= 0) {
+        return result;
+    }
+    // x^-n = 1 / x^n, unless x^n overflowed although the answer is a
+    // tiny nonzero number (2^-1074); then multiply the reciprocals
+    if (isinf(result) && !isinf(base)) {
+        return power_unsigned(1.0 / base, n);
+    }
+    return 1.0 / result;
+}
+
+// Every multiply rounds, and squaring doubles the error already there,
+// so x^n by squaring can be off by about n units in the last place.
+// Above this, op_pow_real lets libm's pow (off by under one) do it.
+#define SQUARING_MAX_EXP 64
+
+double op_pow_real(double base, double exp) {
+    if (exp == floor(exp) && fabs(exp) <= SQUARING_MAX_EXP) {
+        return op_power(base, (int)exp);
+    }
+    return pow(base, exp);
+}
+
+// --- Array versions ---
+
+#ifdef __SSE2__
+
+#define SIMD_BINARY(NAME, INTRIN, OP)                                            \
+    void NAME(double *out, const double *a, const double *b, size_t n) {         \
+        size_t i = 0;                                                            \
+        for (; i + 2 <= n; i += 2) {                                             \
+            _mm_storeu_pd(out + i, INTRIN(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i))); \
+        }                                                                        \
+        for (; i < n; i++) {                                                     \
+            out[i] = a[i] OP b[i];                                               \
+        }                                                                        \
+    }
+
+SIMD_BINARY(op_add_batch, _mm_add_pd, +)
+SIMD_BINARY(op_subtract_batch, _mm_sub_pd, -)
+SIMD_BINARY(op_multiply_batch, _mm_mul_pd, *)
+
+size_t op_divide_batch(double *out, const double *a, const double *b, size_t n,
+                       uint64_t *zero_mask) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128d nan = _mm_set1_pd(NAN);
+    size_t zeros = 0;
+
+    for (size_t word = 0; word * 64 < n; word++) {
+        size_t first = word * 64;
+        size_t last = n - first < 64 ? n : first + 64;
+        uint64_t bits = 0;   // Built in a register, stored once
+        size_t i = first;
+        for (; i + 2 <= last; i += 2) {
+            __m128d x = _mm_loadu_pd(a + i);
+            __m128d y = _mm_loadu_pd(b + i);
+            __m128d is_zero = _mm_cmpeq_pd(y, _mm_castsi128_pd(zero));
+            __m128d q = _mm_div_pd(x, y);
+            _mm_storeu_pd(out + i, _mm_or_pd(_mm_and_pd(is_zero, nan), _mm_andnot_pd(is_zero, q)));
+            bits |= (uint64_t)_mm_movemask_pd(is_zero) << (i - first);
+        }
+        for (; i < last; i++) {
+            out[i] = op_divide(a[i], b[i]);
+            bits |= (uint64_t)(b[i] == 0) << (i - first);
+        }
+        zero_mask[word] = bits;
+        zeros += (size_t)__builtin_popcountll(bits);
+    }
+    return zeros;
+}
+
+// Two lanes squaring together: each lane multiplies its base in where
+// its own exponent has a 1 bit, so lanes with different exponents run
+// the same instructions. Pairs where either exponent is not a whole
+// number up to SQUARING_MAX_EXP, or a negative power overflowed, go to
+// op_pow_real instead.
+void op_power_batch(double *out, const double *base, const double *exp, size_t n) {
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128i low_bit = _mm_set1_epi32(1);
+    const __m128i max_exp = _mm_set1_epi32(SQUARING_MAX_EXP);
+    size_t i = 0;
+
+    for (; i + 2 <= n; i += 2) {
+        __m128d e = _mm_loadu_pd(exp + i);
+        __m128i e32 = _mm_cvttpd_epi32(e);   // [e0, e1, 0, 0]
+        __m128i too_big = _mm_or_si128(_mm_cmpgt_epi32(e32, max_exp),
+                                       _mm_cmplt_epi32(e32, _mm_sub_epi32(_mm_setzero_si128(), max_exp)));
+        if (_mm_movemask_pd(_mm_cmpeq_pd(_mm_cvtepi32_pd(e32), e)) != 3
+            || _mm_movemask_epi8(too_big) != 0) {
+            out[i] = op_pow_real(base[i], exp[i]);
+            out[i + 1] = op_pow_real(base[i + 1], exp[i + 1]);
+            continue;
+        }
+        // |e| as unsigned 32-bit lanes: (e ^ sign) - sign
+        __m128i sign = _mm_srai_epi32(e32, 31);
+        __m128i bits = _mm_sub_epi32(_mm_xor_si128(e32, sign), sign);
+        __m128d x = _mm_loadu_pd(base + i);
+        __m128d result = one;
+        while (_mm_movemask_epi8(_mm_cmpeq_epi32(bits, _mm_setzero_si128())) != 0xFFFF) {
+            // Widen each lane's low bit to a 64-bit double lane mask
+            __m128i odd = _mm_cmpeq_epi32(_mm_and_si128(bits, low_bit), low_bit);
+            __m128d take = _mm_castsi128_pd(_mm_shuffle_epi32(odd, _MM_SHUFFLE(1, 1, 0, 0)));
+            __m128d product = _mm_mul_pd(result, x);
+            result = _mm_or_pd(_mm_and_pd(take, product), _mm_andnot_pd(take, result));
+            x = _mm_mul_pd(x, x);
+            bits = _mm_srli_epi32(bits, 1);
+        }
+        __m128d negative = _mm_castsi128_pd(_mm_shuffle_epi32(sign, _MM_SHUFFLE(1, 1, 0, 0)));
+        __m128d reciprocal = _mm_div_pd(one, result);
+        result = _mm_or_pd(_mm_and_pd(negative, reciprocal), _mm_andnot_pd(negative, result));
+        _mm_storeu_pd(out + i, result);
+        // 1 / inf gave 0: redo those lanes the careful way
+        if (_mm_movemask_pd(_mm_and_pd(negative, _mm_cmpeq_pd(reciprocal, _mm_setzero_pd()))) != 0) {
+            out[i] = op_pow_real(base[i], exp[i]);
+            out[i + 1] = op_pow_real(base[i + 1], exp[i + 1]);
+        }
+    }
+    for (; i < n; i++) {
+        out[i] = op_pow_real(base[i], exp[i]);
+    }
+}
+
+#else
+
+void op_add_batch(double *out, const double *a, const double *b, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = a[i] + b[i];
+}
+
+void op_subtract_batch(double *out, const double *a, const double *b, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = a[i] - b[i];
+}
+
+void op_multiply_batch(double *out, const double *a, const double *b, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = a[i] * b[i];
+}
+
+size_t op_divide_batch(double *out, const double *a, const double *b, size_t n,
+                       uint64_t *zero_mask) {
+    size_t zeros = 0;
+    for (size_t word = 0; word * 64 < n; word++) {
+        zero_mask[word] = 0;
+    }
+    for (size_t i = 0; i < n; i++) {
+        out[i] = op_divide(a[i], b[i]);
+        zero_mask[i / 64] |= (uint64_t)(b[i] == 0) << (i % 64);
+        zeros += b[i] == 0;
+    }
+    return zeros;
+}
+
+void op_power_batch(double *out, const double *base, const double *exp, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = op_pow_real(base[i], exp[i]);
+}
+
+#endif /* __SSE2__ */
+
+// --- Dispatch table ---
+
+const Operation operations[OPERATION_COUNT] = {
+    {'+', "add", op_add},
+    {'-', "sub", op_subtract},
+    {'*', "mul", op_multiply},
+    {'/', "div", op_divide},
+    {'^', "pow", op_pow_real},
+};
+
+int find_operation(const char *token, size_t len) {
+    for (int i = 0; i < OPERATION_COUNT; i++) {
+        if ((len == 1 && token[0] == operations[i].symbol)
+            || (len == strlen(operations[i].name) && memcmp(token, operations[i].name, len) == 0)) {
+            return i;
+        }
+    }
+    return -1;
 }
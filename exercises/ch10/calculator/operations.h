@@ -6,11 +6,46 @@
 #ifndef OPERATIONS_H
 #define OPERATIONS_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 // Function declarations
 double op_add(double a, double b);
 double op_subtract(double a, double b);
 double op_multiply(double a, double b);
-double op_divide(double a, double b);
-double op_power(double base, int exp);
+double op_divide(double a, double b);  // NAN when b is 0
+double op_power(double base, int exp);        // By squaring: O(log exp) multiplies
+double op_pow_real(double base, double exp);  // Any exp; small whole ones use op_power
+
+// Array versions: out[i] = a[i] op b[i]; out may be the same array as
+// a or b. op_divide_batch also sets bit i % 64 of zero_mask[i / 64]
+// where b[i] is 0 (out[i] is NAN there), filling (n + 63) / 64 words,
+// and returns how many bits it set - no branch per element needed.
+void op_add_batch(double *out, const double *a, const double *b, size_t n);
+void op_subtract_batch(double *out, const double *a, const double *b, size_t n);
+void op_multiply_batch(double *out, const double *a, const double *b, size_t n);
+size_t op_divide_batch(double *out, const double *a, const double *b, size_t n,
+                       uint64_t *zero_mask);
+void op_power_batch(double *out, const double *base, const double *exp, size_t n);
+
+// Every operation with the same signature, so callers can pick one by
+// menu number or symbol and call it through a pointer. The order
+// matches the menu: operations[0] is choice 1 (Add).
+typedef double (*BinaryOp)(double a, double b);
+
+typedef struct {
+    char symbol;        // '+', '-', '*', '/', '^'
+    const char *name;   // "add", "sub", "mul", "div", "pow"
+    BinaryOp fn;
+} Operation;
+
+#define OPERATION_COUNT 5
+#define OPERATION_DIVIDE 3
+#define OPERATION_POWER 4
+
+extern const Operation operations[OPERATION_COUNT];
+
+// Index of the operation written as a symbol or name, or -1
+int find_operation(const char *token, size_t len);
 
 #endif /* OPERATIONS_H */
@@ -0,0 +1,418 @@
+/*
+ * bignum.c - Arbitrary-precision unsigned integers
+ *
+ * The low-level helpers work on raw limb arrays; the bn_* functions
+ * around them handle allocation and trimming leading zero limbs.
+ *
+ * Karatsuba splits each operand in half, a = a1*B + a0, b = b1*B + b0:
+ *
+ *   a*b = z2*B^2 + z1*B + z0   where  z0 = a0*b0
+ *                                     z2 = a1*b1
+ *                                     z1 = (a0 + a1)(b0 + b1) - z0 - z2
+ *
+ * Three half-size products instead of four gives O(n^1.585) instead of
+ * O(n^2). Below KARATSUBA_THRESHOLD limbs the bookkeeping costs more than
+ * it saves, so the schoolbook loop takes over.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "bignum.h"
+
+#define KARATSUBA_THRESHOLD 32
+
+typedef unsigned __int128 bn_wide;
+
+// --- Raw limb arrays ---
+
+// r[0..an) = a + b (an >= bn); returns the carry out
+static bn_limb limbs_add(bn_limb *r, const bn_limb *a, size_t an,
+                         const bn_limb *b, size_t bn) {
+    bn_limb carry = 0;
+    size_t i = 0;
+    for (; i < bn; i++) {
+        bn_wide s = (bn_wide)a[i] + b[i] + carry;
+        r[i] = (bn_limb)s;
+        carry = (bn_limb)(s >> 64);
+    }
+    for (; i < an; i++) {
+        bn_limb s = a[i] + carry;
+        carry = s < carry;
+        r[i] = s;
+    }
+    return carry;
+}
+
+// r[0..rn) -= b[0..bn) (rn >= bn, r >= b)
+static void limbs_sub_inplace(bn_limb *r, size_t rn, const bn_limb *b, size_t bn) {
+    bn_limb borrow = 0;
+    size_t i = 0;
+    for (; i < bn; i++) {
+        bn_limb x = r[i];
+        bn_limb d = x - b[i] - borrow;
+        borrow = (x < b[i]) | ((x == b[i]) & borrow);
+        r[i] = d;
+    }
+    for (; borrow && i < rn; i++) {
+        borrow = r[i] == 0;
+        r[i]--;
+    }
+}
+
+static size_t limbs_trim(const bn_limb *a, size_t n) {
+    while (n > 0 && a[n - 1] == 0) {
+        n--;
+    }
+    return n;
+}
+
+// r[0..an+bn) = a * b; r must not overlap a or b
+static void mul_schoolbook(bn_limb *r, const bn_limb *a, size_t an,
+                           const bn_limb *b, size_t bn) {
+    memset(r, 0, (an + bn) * sizeof(bn_limb));
+    for (size_t i = 0; i < an; i++) {
+        bn_limb carry = 0;
+        bn_limb ai = a[i];
+        for (size_t j = 0; j < bn; j++) {
+            bn_wide t = (bn_wide)ai * b[j] + r[i + j] + carry;
+            r[i + j] = (bn_limb)t;
+            carry = (bn_limb)(t >> 64);
+        }
+        r[i + bn] = carry;
+    }
+}
+
+// r[0..an+bn) = a * b; r must not overlap a or b. Returns 0 on
+// allocation failure.
+static int mul_limbs(bn_limb *r, const bn_limb *a, size_t an,
+                     const bn_limb *b, size_t bn) {
+    if (an < bn) {
+        const bn_limb *t = a;
+        a = b;
+        b = t;
+        size_t tn = an;
+        an = bn;
+        bn = tn;
+    }
+    if (bn < KARATSUBA_THRESHOLD) {
+        mul_schoolbook(r, a, an, b, bn);
+        return 1;
+    }
+
+    // Very different sizes: multiply b by bn-limb slices of a
+    if (an >= 2 * bn) {
+        bn_limb *part = malloc(2 * bn * sizeof(bn_limb));
+        if (part == NULL) {
+            return 0;
+        }
+        memset(r, 0, (an + bn) * sizeof(bn_limb));
+        for (size_t i = 0; i < an; i += bn) {
+            size_t slice = an - i < bn ? an - i : bn;
+            if (!mul_limbs(part, a + i, slice, b, bn)) {
+                free(part);
+                return 0;
+            }
+            // The sum fits in r, so the final carry is always zero
+            limbs_add(r + i, r + i, an + bn - i, part, slice + bn);
+        }
+        free(part);
+        return 1;
+    }
+
+    // Karatsuba: a = a1*B^m + a0, b = b1*B^m + b0 with m < bn <= an
+    size_t m = an / 2;
+    const bn_limb *a0 = a, *a1 = a + m;
+    const bn_limb *b0 = b, *b1 = b + m;
+    size_t a1n = an - m, b1n = bn - m;
+
+    // a1n >= m, but b1 may be shorter or longer than b0
+    size_t san = a1n + 1;
+    size_t sbn = (b1n > m ? b1n : m) + 1;
+    size_t z1n = san + sbn;
+    bn_limb *scratch = malloc((san + sbn + z1n) * sizeof(bn_limb));
+    if (scratch == NULL) {
+        return 0;
+    }
+    bn_limb *sa = scratch, *sb = sa + san, *z1 = sb + sbn;
+
+    sa[a1n] = limbs_add(sa, a1, a1n, a0, m);
+    if (b1n >= m) {
+        sb[b1n] = limbs_add(sb, b1, b1n, b0, m);
+    } else {
+        sb[m] = limbs_add(sb, b0, m, b1, b1n);
+    }
+
+    // z0 into the low half of r, z2 into the high half
+    if (!mul_limbs(r, a0, m, b0, m)
+        || !mul_limbs(r + 2 * m, a1, a1n, b1, b1n)
+        || !mul_limbs(z1, sa, san, sb, sbn)) {
+        free(scratch);
+        return 0;
+    }
+    limbs_sub_inplace(z1, z1n, r, 2 * m);
+    limbs_sub_inplace(z1, z1n, r + 2 * m, a1n + b1n);
+
+    // z1 = a0*b1 + a1*b0, which always fits in the rest of r
+    z1n = limbs_trim(z1, z1n);
+    limbs_add(r + m, r + m, an + bn - m, z1, z1n);
+    free(scratch);
+    return 1;
+}
+
+// --- BigNum ---
+
+void bn_init(BigNum *a) {
+    a->limbs = NULL;
+    a->len = 0;
+    a->cap = 0;
+}
+
+void bn_free(BigNum *a) {
+    free(a->limbs);
+    bn_init(a);
+}
+
+int bn_reserve(BigNum *a, size_t limbs) {
+    if (limbs <= a->cap) {
+        return 1;
+    }
+    size_t cap = a->cap ? a->cap : 4;
+    while (cap < limbs) {
+        cap *= 2;
+    }
+    bn_limb *grown = realloc(a->limbs, cap * sizeof(bn_limb));
+    if (grown == NULL) {
+        return 0;
+    }
+    a->limbs = grown;
+    a->cap = cap;
+    return 1;
+}
+
+int bn_set_u64(BigNum *a, uint64_t value) {
+    if (!bn_reserve(a, 1)) {
+        return 0;
+    }
+    a->limbs[0] = value;
+    a->len = value != 0;
+    return 1;
+}
+
+int bn_copy(BigNum *dst, const BigNum *src) {
+    if (dst == src) {
+        return 1;
+    }
+    if (!bn_reserve(dst, src->len)) {
+        return 0;
+    }
+    if (src->len > 0) {
+        memcpy(dst->limbs, src->limbs, src->len * sizeof(bn_limb));
+    }
+    dst->len = src->len;
+    return 1;
+}
+
+void bn_swap(BigNum *a, BigNum *b) {
+    BigNum t = *a;
+    *a = *b;
+    *b = t;
+}
+
+int bn_is_zero(const BigNum *a) {
+    return a->len == 0;
+}
+
+int bn_cmp(const BigNum *a, const BigNum *b) {
+    if (a->len != b->len) {
+        return a->len < b->len ? -1 : 1;
+    }
+    for (size_t i = a->len; i-- > 0;) {
+        if (a->limbs[i] != b->limbs[i]) {
+            return a->limbs[i] < b->limbs[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+size_t bn_bits(const BigNum *a) {
+    if (a->len == 0) {
+        return 0;
+    }
+    return a->len * 64 - (size_t)__builtin_clzll(a->limbs[a->len - 1]);
+}
+
+int bn_add(BigNum *r, const BigNum *a, const BigNum *b) {
+    if (a->len < b->len) {
+        const BigNum *t = a;
+        a = b;
+        b = t;
+    }
+    size_t an = a->len, bn = b->len;
+    if (!bn_reserve(r, an + 1)) {
+        return 0;
+    }
+    // Read the limb pointers after reserving: r may be a or b
+    bn_limb carry = limbs_add(r->limbs, a->limbs, an, b->limbs, bn);
+    r->limbs[an] = carry;
+    r->len = an + (carry != 0);
+    return 1;
+}
+
+int bn_sub(BigNum *r, const BigNum *a, const BigNum *b) {
+    if (a == b) {
+        r->len = 0;
+        return 1;
+    }
+    if (r == b) {
+        // Copying a into r would overwrite b, so work in a temporary
+        BigNum t;
+        bn_init(&t);
+        if (!bn_sub(&t, a, b)) {
+            bn_free(&t);
+            return 0;
+        }
+        bn_swap(r, &t);
+        bn_free(&t);
+        return 1;
+    }
+    if (!bn_copy(r, a)) {
+        return 0;
+    }
+    limbs_sub_inplace(r->limbs, r->len, b->limbs, b->len);
+    r->len = limbs_trim(r->limbs, r->len);
+    return 1;
+}
+
+int bn_mul(BigNum *r, const BigNum *a, const BigNum *b) {
+    if (a->len == 0 || b->len == 0) {
+        r->len = 0;
+        return 1;
+    }
+    // Multiply into a fresh buffer so r may alias a or b
+    size_t n = a->len + b->len;
+    bn_limb *out = malloc(n * sizeof(bn_limb));
+    if (out == NULL || !mul_limbs(out, a->limbs, a->len, b->limbs, b->len)) {
+        free(out);
+        return 0;
+    }
+    free(r->limbs);
+    r->limbs = out;
+    r->cap = n;
+    r->len = limbs_trim(out, n);
+    return 1;
+}
+
+int bn_mul_u64(BigNum *r, const BigNum *a, uint64_t m) {
+    size_t n = a->len;
+    if (n == 0 || m == 0) {
+        r->len = 0;
+        return 1;
+    }
+    if (!bn_reserve(r, n + 1)) {
+        return 0;
+    }
+    bn_limb carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        bn_wide t = (bn_wide)a->limbs[i] * m + carry;
+        r->limbs[i] = (bn_limb)t;
+        carry = (bn_limb)(t >> 64);
+    }
+    r->limbs[n] = carry;
+    r->len = n + (carry != 0);
+    return 1;
+}
+
+int bn_shl(BigNum *r, const BigNum *a, size_t bits) {
+    size_t n = a->len;
+    if (n == 0) {
+        r->len = 0;
+        return 1;
+    }
+    size_t shift_limbs = bits / 64;
+    unsigned s = bits % 64;
+    if (!bn_reserve(r, n + shift_limbs + 1)) {
+        return 0;
+    }
+    // Work from the top down so r may be a
+    bn_limb *rl = r->limbs;
+    const bn_limb *al = a->limbs;
+    rl[n + shift_limbs] = s ? al[n - 1] >> (64 - s) : 0;
+    for (size_t i = n; i-- > 0;) {
+        bn_limb low_bits = (s && i > 0) ? al[i - 1] >> (64 - s) : 0;
+        rl[i + shift_limbs] = (al[i] << s) | low_bits;
+    }
+    memset(rl, 0, shift_limbs * sizeof(bn_limb));
+    r->len = limbs_trim(rl, n + shift_limbs + 1);
+    return 1;
+}
+
+// Repeatedly divide by 10^9, working on 32-bit halves so each step is a
+// 64-bit division by a constant (a multiply) rather than a 128-bit one.
+// Quadratic, but fine up to a few hundred thousand digits.
+char *bn_to_string(const BigNum *a) {
+    if (a->len == 0) {
+        char *zero = malloc(2);
+        if (zero != NULL) {
+            strcpy(zero, "0");
+        }
+        return zero;
+    }
+
+    size_t halves = a->len * 2;
+    uint32_t *h = malloc(halves * sizeof(uint32_t));
+    // 9 decimal digits per chunk; 64 bits < 20 digits, so 3 chunks per limb
+    size_t max_chunks = a->len * 3 + 1;
+    uint32_t *chunks = malloc(max_chunks * sizeof(uint32_t));
+    char *text = malloc(max_chunks * 9 + 1);
+    if (h == NULL || chunks == NULL || text == NULL) {
+        free(h);
+        free(chunks);
+        free(text);
+        return NULL;
+    }
+    for (size_t i = 0; i < a->len; i++) {
+        h[2 * i] = (uint32_t)a->limbs[i];
+        h[2 * i + 1] = (uint32_t)(a->limbs[i] >> 32);
+    }
+
+    size_t count = 0;
+    size_t top = halves;
+    while (top > 0) {
+        uint64_t rem = 0;
+        for (size_t i = top; i-- > 0;) {
+            uint64_t cur = (rem << 32) | h[i];
+            h[i] = (uint32_t)(cur / 1000000000u);
+            rem = cur % 1000000000u;
+        }
+        chunks[count++] = (uint32_t)rem;
+        while (top > 0 && h[top - 1] == 0) {
+            top--;
+        }
+    }
+
+    // Most significant chunk without padding, the rest as 9 digits each
+    char *p = text;
+    uint32_t lead = chunks[count - 1];
+    char tmp[10];
+    int n = 0;
+    do {
+        tmp[n++] = (char)('0' + lead % 10);
+        lead /= 10;
+    } while (lead > 0);
+    while (n > 0) {
+        *p++ = tmp[--n];
+    }
+    for (size_t c = count - 1; c-- > 0;) {
+        uint32_t v = chunks[c];
+        for (int d = 8; d >= 0; d--) {
+            p[d] = (char)('0' + v % 10);
+            v /= 10;
+        }
+        p += 9;
+    }
+    *p = '\0';
+
+    free(h);
+    free(chunks);
+    return text;
+}
@@ -0,0 +1,56 @@
+/*
+ * bignum.h - Arbitrary-precision unsigned integers
+ *
+ * Python ints never overflow; C's largest built-in integer tops out at
+ * 2^64 - 1 (F(93), 20!). A BigNum stores a number as an array of 64-bit
+ * "limbs", least significant first - the same idea as writing a number
+ * in base 2^64 instead of base 10:
+ *
+ *   value = limbs[0] + limbs[1] * 2^64 + limbs[2] * 2^128 + ...
+ *
+ * Multiplication uses the schoolbook method for small operands and
+ * Karatsuba (3 half-size multiplies instead of 4) for large ones.
+ *
+ * Functions that may allocate return 1 on success and 0 if memory ran
+ * out. The result may be the same BigNum as an operand.
+ *
+ * Build: add ../common/bignum.c to the cc command line.
+ */
+
+#ifndef BIGNUM_H
+#define BIGNUM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint64_t bn_limb;
+
+typedef struct {
+    bn_limb *limbs;  // Least significant limb first
+    size_t len;      // Limbs in use; 0 means the value is zero
+    size_t cap;      // Limbs allocated
+} BigNum;
+
+// Start every BigNum with bn_init (value 0) and release it with bn_free
+void bn_init(BigNum *a);
+void bn_free(BigNum *a);
+int bn_reserve(BigNum *a, size_t limbs);
+
+int bn_set_u64(BigNum *a, uint64_t value);
+int bn_copy(BigNum *dst, const BigNum *src);
+void bn_swap(BigNum *a, BigNum *b);
+
+int bn_is_zero(const BigNum *a);
+int bn_cmp(const BigNum *a, const BigNum *b);  // Returns -1, 0, or 1
+size_t bn_bits(const BigNum *a);               // 0 for zero
+
+int bn_add(BigNum *r, const BigNum *a, const BigNum *b);
+int bn_sub(BigNum *r, const BigNum *a, const BigNum *b);  // Requires a >= b
+int bn_mul(BigNum *r, const BigNum *a, const BigNum *b);
+int bn_mul_u64(BigNum *r, const BigNum *a, uint64_t m);
+int bn_shl(BigNum *r, const BigNum *a, size_t bits);  // r = a * 2^bits
+
+// Decimal digits as a new NUL-terminated string (free it), or NULL
+char *bn_to_string(const BigNum *a);
+
+#endif /* BIGNUM_H */
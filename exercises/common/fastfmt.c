@@ -0,0 +1,434 @@
+/*
+ * fastfmt.c - Fast number formatting and buffered output
+ *
+ * Integers: peel off two digits at a time (v % 100) and copy them from
+ * a 200-byte table of "00".."99", halving the divisions.
+ *
+ * Fixed decimals (%.2f): a double is exactly m * 2^e with a 53-bit m, so
+ * x * 100 = m * 100 * 2^e fits in 128 bits and can be rounded exactly
+ * (half to even, like printf) with a shift instead of a decimal
+ * expansion.
+ *
+ * Shortest doubles: the Ryu algorithm (Ulf Adams, 2018). Every double
+ * owns an interval of reals that round to it; Ryu scales the interval's
+ * two ends and its centre by a power of 10 using 128-bit table entries
+ * (fastfmt_pow5.h), then drops decimal digits while both ends still
+ * agree. What is left is the shortest digit string that reads back as
+ * the same double - the same digits Python's repr() prints.
+ */
+
+#include <string.h>
+#include "fastfmt.h"
+#include "fastfmt_pow5.h"
+
+typedef unsigned __int128 fmt_u128;
+
+static const char digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// --- Sink ---
+
+void fmt_sink_init(FmtSink *s, FILE *out) {
+    s->out = out;
+    s->used = 0;
+    s->ok = 1;
+}
+
+int fmt_flush(FmtSink *s) {
+    if (s->used > 0 && fwrite(s->buf, 1, s->used, s->out) != s->used) {
+        s->ok = 0;
+    }
+    s->used = 0;
+    return s->ok;
+}
+
+void fmt_mem(FmtSink *s, const char *data, size_t len) {
+    if (len > FMT_SINK_SIZE - s->used) {
+        fmt_flush(s);
+        if (len >= FMT_SINK_SIZE) {
+            if (fwrite(data, 1, len, s->out) != len) {
+                s->ok = 0;
+            }
+            return;
+        }
+    }
+    memcpy(s->buf + s->used, data, len);
+    s->used += len;
+}
+
+void fmt_str(FmtSink *s, const char *str) {
+    fmt_mem(s, str, strlen(str));
+}
+
+void fmt_str_pad(FmtSink *s, const char *str, int width) {
+    size_t len = strlen(str);
+    fmt_mem(s, str, len);
+    for (int i = (int)len; i < width; i++) {
+        fmt_char(s, ' ');
+    }
+}
+
+// --- Integers ---
+
+size_t fmt_u64_buf(char *buf, uint64_t value) {
+    char tmp[FMT_U64_MAX];
+    char *p = tmp + FMT_U64_MAX;
+    while (value >= 100) {
+        uint64_t pair = value % 100;
+        value /= 100;
+        p -= 2;
+        memcpy(p, digit_pairs + 2 * pair, 2);
+    }
+    if (value >= 10) {
+        p -= 2;
+        memcpy(p, digit_pairs + 2 * value, 2);
+    } else {
+        *--p = (char)('0' + value);
+    }
+    size_t len = (size_t)(tmp + FMT_U64_MAX - p);
+    memcpy(buf, p, len);
+    return len;
+}
+
+void fmt_u64(FmtSink *s, uint64_t value) {
+    char *d = fmt_reserve(s, FMT_U64_MAX);
+    s->used += fmt_u64_buf(d, value);
+}
+
+void fmt_i64(FmtSink *s, int64_t value) {
+    char *d = fmt_reserve(s, FMT_U64_MAX + 1);
+    if (value < 0) {
+        *d = '-';
+        // Negate as unsigned so INT64_MIN works
+        s->used += 1 + fmt_u64_buf(d + 1, 0 - (uint64_t)value);
+    } else {
+        s->used += fmt_u64_buf(d, (uint64_t)value);
+    }
+}
+
+void fmt_i64_zero_pad(FmtSink *s, int64_t value, int width) {
+    char digits[FMT_U64_MAX];
+    int negative = value < 0;
+    uint64_t magnitude = negative ? 0 - (uint64_t)value : (uint64_t)value;
+    size_t len = fmt_u64_buf(digits, magnitude);
+    if (negative) {
+        fmt_char(s, '-');
+    }
+    // Like printf, the sign counts towards the width
+    for (int i = (int)len + negative; i < width; i++) {
+        fmt_char(s, '0');
+    }
+    fmt_mem(s, digits, len);
+}
+
+// --- Fixed decimals ---
+
+static const uint64_t pow10_u64[10] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+};
+
+// round(|value| * 10^decimals) exactly, or 0 if it does not fit the fast
+// path (NaN, infinity, too many decimals, or a result of 2^64 or more)
+static int fixed_scaled(double value, int decimals, uint64_t *out) {
+    if (decimals < 0 || decimals > 9) {
+        return 0;
+    }
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    int exponent = (int)((bits >> 52) & 0x7FF);
+    uint64_t mantissa = bits & ((1ULL << 52) - 1);
+    if (exponent == 0x7FF) {
+        return 0;
+    }
+    // value = m * 2^e exactly
+    uint64_t m = exponent == 0 ? mantissa : mantissa | (1ULL << 52);
+    int e = exponent == 0 ? -1074 : exponent - 1075;
+    uint64_t scale = pow10_u64[decimals];
+
+    if (e >= 0) {
+        if (e > 10) {
+            return 0;  // 2^63 or more: out of range anyway
+        }
+        uint64_t integer = m << e;
+        if (integer > UINT64_MAX / scale) {
+            return 0;
+        }
+        *out = integer * scale;
+        return 1;
+    }
+    int shift = -e;
+    fmt_u128 product = (fmt_u128)m * scale;  // < 2^83
+    if (shift >= 84) {
+        *out = 0;  // Below half a unit in the last place
+        return 1;
+    }
+    fmt_u128 q = product >> shift;
+    fmt_u128 rem = product & (((fmt_u128)1 << shift) - 1);
+    fmt_u128 half = (fmt_u128)1 << (shift - 1);
+    if (rem > half || (rem == half && (q & 1))) {
+        q++;
+    }
+    if (q > UINT64_MAX) {
+        return 0;
+    }
+    *out = (uint64_t)q;
+    return 1;
+}
+
+void fmt_fixed(FmtSink *s, double value, int decimals) {
+    uint64_t scaled;
+    if (!fixed_scaled(value, decimals, &scaled)) {
+        fmt_flush(s);
+        if (fprintf(s->out, "%.*f", decimals, value) < 0) {
+            s->ok = 0;
+        }
+        return;
+    }
+    // printf keeps the sign of negative values that round to zero: -0.00
+    char *d = fmt_reserve(s, FMT_U64_MAX + 12);
+    char *p = d;
+    if (value < 0 || (value == 0 && 1 / value < 0)) {
+        *p++ = '-';
+    }
+    uint64_t scale = pow10_u64[decimals];
+    p += fmt_u64_buf(p, scaled / scale);
+    if (decimals > 0) {
+        *p++ = '.';
+        uint64_t frac = scaled % scale;
+        for (int i = decimals - 1; i >= 0; i--) {
+            p[i] = (char)('0' + frac % 10);
+            frac /= 10;
+        }
+        p += decimals;
+    }
+    s->used += (size_t)(p - d);
+}
+
+// --- Shortest doubles (Ryu) ---
+
+// floor(log2(5^e)) + 1, floor(log10(2^e)) and floor(log10(5^e)),
+// valid over the double exponent range
+static inline int pow5_bits(int e) {
+    return (int)(((uint32_t)e * 1217359) >> 19) + 1;
+}
+
+static inline int log10_pow2(int e) {
+    return (int)(((uint32_t)e * 78913) >> 18);
+}
+
+static inline int log10_pow5(int e) {
+    return (int)(((uint32_t)e * 732923) >> 20);
+}
+
+static inline int pow5_factor(uint64_t value) {
+    int count = 0;
+    while (value % 5 == 0) {
+        value /= 5;
+        count++;
+    }
+    return count;
+}
+
+static inline int multiple_of_pow5(uint64_t value, int p) {
+    return pow5_factor(value) >= p;
+}
+
+static inline int multiple_of_pow2(uint64_t value, int p) {
+    return (value & ((1ULL << p) - 1)) == 0;
+}
+
+// (m * mul) >> j for a 128-bit mul and j >= 64
+static inline uint64_t mul_shift(uint64_t m, const uint64_t *mul, int j) {
+    fmt_u128 low = (fmt_u128)m * mul[0];
+    fmt_u128 high = (fmt_u128)m * mul[1];
+    return (uint64_t)(((low >> 64) + high) >> (j - 64));
+}
+
+// Shortest decimal for a finite, nonzero double: value = digits * 10^exp
+static void ryu(uint64_t ieee_mantissa, int ieee_exponent, uint64_t *digits, int *exp10) {
+    int e2;
+    uint64_t m2;
+    if (ieee_exponent == 0) {
+        e2 = 1 - 1023 - 52 - 2;
+        m2 = ieee_mantissa;
+    } else {
+        e2 = ieee_exponent - 1023 - 52 - 2;
+        m2 = (1ULL << 52) | ieee_mantissa;
+    }
+    int even = (m2 & 1) == 0;
+    int accept_bounds = even;
+
+    // The centre (mv) and the two ends of the rounding interval, times 4.
+    // The lower gap is half as wide at powers of two.
+    uint64_t mv = 4 * m2;
+    int mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+
+    uint64_t vr, vp, vm;
+    int e10;
+    int vm_trailing_zeros = 0;
+    int vr_trailing_zeros = 0;
+    if (e2 >= 0) {
+        int q = log10_pow2(e2) - (e2 > 3);
+        e10 = q;
+        int k = 125 + pow5_bits(q) - 1;
+        int i = -e2 + q + k;
+        vr = mul_shift(4 * m2, fmt_pow5_inv[q], i);
+        vp = mul_shift(4 * m2 + 2, fmt_pow5_inv[q], i);
+        vm = mul_shift(4 * m2 - 1 - (uint64_t)mm_shift, fmt_pow5_inv[q], i);
+        if (q <= 21) {
+            // Only one of mp, mv and mm can be a multiple of 5, if any
+            if (mv % 5 == 0) {
+                vr_trailing_zeros = multiple_of_pow5(mv, q);
+            } else if (accept_bounds) {
+                vm_trailing_zeros = multiple_of_pow5(mv - 1 - (uint64_t)mm_shift, q);
+            } else {
+                vp -= (uint64_t)multiple_of_pow5(mv + 2, q);
+            }
+        }
+    } else {
+        int q = log10_pow5(-e2) - (-e2 > 1);
+        e10 = q + e2;
+        int i = -e2 - q;
+        int k = pow5_bits(i) - 125;
+        int j = q - k;
+        vr = mul_shift(4 * m2, fmt_pow5[i], j);
+        vp = mul_shift(4 * m2 + 2, fmt_pow5[i], j);
+        vm = mul_shift(4 * m2 - 1 - (uint64_t)mm_shift, fmt_pow5[i], j);
+        if (q <= 1) {
+            // mv has at least q trailing zero bits, so vr is exact
+            vr_trailing_zeros = 1;
+            if (accept_bounds) {
+                vm_trailing_zeros = mm_shift == 1;
+            } else {
+                vp--;
+            }
+        } else if (q < 63) {
+            vr_trailing_zeros = multiple_of_pow2(mv, q);
+        }
+    }
+
+    // Drop digits while the interval still contains a shorter number
+    int removed = 0;
+    int last_removed = 0;
+    uint64_t output;
+    if (vm_trailing_zeros || vr_trailing_zeros) {
+        // Rare: an end or the centre is exact, so ties need care
+        while (vp / 10 > vm / 10) {
+            vm_trailing_zeros &= vm % 10 == 0;
+            vr_trailing_zeros &= last_removed == 0;
+            last_removed = (int)(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        if (vm_trailing_zeros) {
+            while (vm % 10 == 0) {
+                vr_trailing_zeros &= last_removed == 0;
+                last_removed = (int)(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+        if (vr_trailing_zeros && last_removed == 5 && vr % 2 == 0) {
+            last_removed = 4;  // Exactly halfway: round to even
+        }
+        output = vr + ((vr == vm && (!accept_bounds || !vm_trailing_zeros)) || last_removed >= 5);
+    } else {
+        int round_up = 0;
+        while (vp / 10 > vm / 10) {
+            round_up = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        output = vr + (vr == vm || round_up);
+    }
+    *digits = output;
+    *exp10 = e10 + removed;
+}
+
+// Python's float repr: positional for 1e-4 <= |x| < 1e16, otherwise
+// scientific with at least two exponent digits
+size_t fmt_double_buf(char *buf, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    int negative = (int)(bits >> 63);
+    int exponent = (int)((bits >> 52) & 0x7FF);
+    uint64_t mantissa = bits & ((1ULL << 52) - 1);
+    char *p = buf;
+
+    if (exponent == 0x7FF) {
+        if (mantissa != 0) {
+            memcpy(p, "nan", 3);
+            return 3;
+        }
+        if (negative) *p++ = '-';
+        memcpy(p, "inf", 3);
+        return (size_t)(p - buf) + 3;
+    }
+    if (negative) {
+        *p++ = '-';
+    }
+    if (exponent == 0 && mantissa == 0) {
+        memcpy(p, "0.0", 3);
+        return (size_t)(p - buf) + 3;
+    }
+
+    uint64_t output;
+    int exp10;
+    ryu(mantissa, exponent, &output, &exp10);
+    char digits[FMT_U64_MAX];
+    int len = (int)fmt_u64_buf(digits, output);
+    int point = len + exp10;  // Digits before the decimal point
+
+    if (point <= -4 || point > 16) {
+        *p++ = digits[0];
+        if (len > 1) {
+            *p++ = '.';
+            memcpy(p, digits + 1, (size_t)len - 1);
+            p += len - 1;
+        }
+        int e = point - 1;
+        *p++ = 'e';
+        *p++ = e < 0 ? '-' : '+';
+        if (e < 0) e = -e;
+        if (e >= 100) {
+            *p++ = (char)('0' + e / 100);
+            e %= 100;
+        }
+        memcpy(p, digit_pairs + 2 * e, 2);
+        p += 2;
+    } else if (point <= 0) {
+        *p++ = '0';
+        *p++ = '.';
+        memset(p, '0', (size_t)-point);
+        p += -point;
+        memcpy(p, digits, (size_t)len);
+        p += len;
+    } else if (point >= len) {
+        memcpy(p, digits, (size_t)len);
+        p += len;
+        memset(p, '0', (size_t)(point - len));
+        p += point - len;
+        memcpy(p, ".0", 2);
+        p += 2;
+    } else {
+        memcpy(p, digits, (size_t)point);
+        p += point;
+        *p++ = '.';
+        memcpy(p, digits + point, (size_t)(len - point));
+        p += len - point;
+    }
+    return (size_t)(p - buf);
+}
+
+void fmt_double(FmtSink *s, double value) {
+    char *d = fmt_reserve(s, FMT_DOUBLE_MAX);
+    s->used += fmt_double_buf(d, value);
+}
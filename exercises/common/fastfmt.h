@@ -0,0 +1,75 @@
+/*
+ * fastfmt.h - Fast number formatting and buffered output
+ *
+ * printf parses its format string on every call and locks stdout for
+ * each one; printing a million numbers that way spends most of its time
+ * on neither the numbers nor the output. Here each value type has its
+ * own function, and output collects in an FmtSink buffer that is handed
+ * to stdio one large block at a time.
+ *
+ *   printf("%d", n)        ->  fmt_i64(&sink, n)
+ *   printf("%04d", n)      ->  fmt_i64_zero_pad(&sink, n, 4)
+ *   printf("%-*s", w, s)   ->  fmt_str_pad(&sink, s, w)
+ *   printf("%.2f", x)      ->  fmt_fixed(&sink, x, 2)
+ *   print(repr(x))         ->  fmt_double(&sink, x)   (Python's float repr)
+ *
+ * The output is identical to printf's (or Python's, for fmt_double).
+ * Anything the fast paths do not cover, like %.2f of 1e300, falls back
+ * to snprintf.
+ *
+ * A sink writes through a FILE *, so it can be mixed with printf as long
+ * as fmt_flush runs before the next printf.
+ *
+ * Build: add ../common/fastfmt.c to the cc command line.
+ */
+
+#ifndef FASTFMT_H
+#define FASTFMT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define FMT_SINK_SIZE 8192
+#define FMT_DOUBLE_MAX 25   // Longest fmt_double output: "-2.2250738585072014e-308"
+#define FMT_U64_MAX 20      // 18446744073709551615
+
+typedef struct {
+    FILE *out;
+    size_t used;
+    int ok;                 // 0 once a write has failed
+    char buf[FMT_SINK_SIZE];
+} FmtSink;
+
+void fmt_sink_init(FmtSink *s, FILE *out);
+int fmt_flush(FmtSink *s);  // Returns 1 if every write so far succeeded
+
+// Room for n (<= FMT_SINK_SIZE) more bytes at the end of the buffer
+static inline char *fmt_reserve(FmtSink *s, size_t n) {
+    if (FMT_SINK_SIZE - s->used < n) {
+        fmt_flush(s);
+    }
+    return s->buf + s->used;
+}
+
+static inline void fmt_char(FmtSink *s, char c) {
+    *fmt_reserve(s, 1) = c;
+    s->used++;
+}
+
+void fmt_mem(FmtSink *s, const char *data, size_t len);
+void fmt_str(FmtSink *s, const char *str);
+void fmt_str_pad(FmtSink *s, const char *str, int width);     // "%-*s"
+
+void fmt_u64(FmtSink *s, uint64_t value);                     // "%llu"
+void fmt_i64(FmtSink *s, int64_t value);                      // "%lld"
+void fmt_i64_zero_pad(FmtSink *s, int64_t value, int width);  // "%0*lld"
+void fmt_fixed(FmtSink *s, double value, int decimals);       // "%.*f"
+void fmt_double(FmtSink *s, double value);                    // repr(value)
+
+// The same conversions into a caller's buffer; return the length written
+// (no NUL terminator)
+size_t fmt_u64_buf(char *buf, uint64_t value);    // buf: FMT_U64_MAX bytes
+size_t fmt_double_buf(char *buf, double value);   // buf: FMT_DOUBLE_MAX bytes
+
+#endif /* FASTFMT_H */
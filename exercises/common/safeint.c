@@ -0,0 +1,212 @@
+/*
+ * safeint.c - Array versions of checked and saturating arithmetic
+ *
+ * A checked loop written the obvious way branches on every element:
+ *
+ *   for (i = 0; i < n; i++)
+ *       if (__builtin_add_overflow(a[i], b[i], &out[i])) return 0;
+ *
+ * These versions instead OR each element's overflow bit into one flag
+ * and look at it once at the end, so the loop body has no branches.
+ *
+ * On x86 the 8- and 16-bit add/sub use SSE2's packed saturating
+ * instructions (paddsb, paddusw, ...), 16 bytes per instruction. A lane
+ * overflowed exactly when the saturated and wrapped results differ.
+ * 32/64-bit add/sub and 16-bit mul have no saturating instruction, so
+ * the overflow mask is built from sign bits:
+ *
+ *   signed add:   r = a + b overflowed if a and b agree in sign and r
+ *                 does not, i.e. the top bit of (a ^ r) & (b ^ r)
+ *   unsigned add: the carry out of the top bit, the top bit of
+ *                 (a & b) | ((a | b) & ~r)
+ *
+ * and the mask picks between the wrapped and clamped values. Everything
+ * else, and the last few elements, runs the scalar code from safeint.h.
+ */
+
+#include "safeint.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Fallback for operations without a SIMD kernel: nothing done
+#define NO_SIMD(out, a, b, n, saturate, overflow) 0
+
+#ifdef __SSE2__
+
+// --- 8/16-bit add/sub: packed saturating instructions ---
+
+#define SIMD_SATURATING(NAME, T, OP, SAT, WRAP)                                  \
+    static size_t simd_##OP##_##NAME(T *out, const T *a, const T *b, size_t n,   \
+                                     int saturate, int *overflow) {              \
+        __m128i diff = _mm_setzero_si128();                                      \
+        size_t i = 0;                                                            \
+        for (; i + 16 / sizeof(T) <= n; i += 16 / sizeof(T)) {                   \
+            __m128i x = _mm_loadu_si128((const __m128i *)(a + i));               \
+            __m128i y = _mm_loadu_si128((const __m128i *)(b + i));               \
+            __m128i s = SAT(x, y);                                               \
+            __m128i w = WRAP(x, y);                                              \
+            diff = _mm_or_si128(diff, _mm_xor_si128(s, w));                      \
+            _mm_storeu_si128((__m128i *)(out + i), saturate ? s : w);            \
+        }                                                                        \
+        *overflow |= _mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())) != 0xFFFF; \
+        return i;                                                                \
+    }
+
+SIMD_SATURATING(i8, int8_t, add, _mm_adds_epi8, _mm_add_epi8)
+SIMD_SATURATING(i8, int8_t, sub, _mm_subs_epi8, _mm_sub_epi8)
+SIMD_SATURATING(u8, uint8_t, add, _mm_adds_epu8, _mm_add_epi8)
+SIMD_SATURATING(u8, uint8_t, sub, _mm_subs_epu8, _mm_sub_epi8)
+SIMD_SATURATING(i16, int16_t, add, _mm_adds_epi16, _mm_add_epi16)
+SIMD_SATURATING(i16, int16_t, sub, _mm_subs_epi16, _mm_sub_epi16)
+SIMD_SATURATING(u16, uint16_t, add, _mm_adds_epu16, _mm_add_epi16)
+SIMD_SATURATING(u16, uint16_t, sub, _mm_subs_epu16, _mm_sub_epi16)
+
+// --- 32/64-bit add/sub and 16-bit mul: overflow masks from sign bits ---
+
+// Every bit of a lane set if the lane's top bit is set
+static inline __m128i top_bit_32(__m128i x) {
+    return _mm_srai_epi32(x, 31);
+}
+
+static inline __m128i top_bit_64(__m128i x) {
+    return _mm_shuffle_epi32(_mm_srai_epi32(x, 31), _MM_SHUFFLE(3, 3, 1, 1));
+}
+
+static inline __m128i top_bit_16(__m128i x) {
+    return _mm_srai_epi16(x, 15);
+}
+
+static inline __m128i blend(__m128i mask, __m128i yes, __m128i no) {
+    return _mm_or_si128(_mm_and_si128(mask, yes), _mm_andnot_si128(mask, no));
+}
+
+// x, y: inputs; r: wrapped result. Each defines mask (lanes that
+// overflowed) and clamp (the saturated value for those lanes).
+#define SIGNED_ADD(W, MAXV)                                                      \
+    __m128i mask = top_bit_##W(_mm_and_si128(_mm_xor_si128(x, r), _mm_xor_si128(y, r))); \
+    __m128i clamp = _mm_xor_si128(top_bit_##W(x), MAXV)
+#define SIGNED_SUB(W, MAXV)                                                      \
+    __m128i mask = top_bit_##W(_mm_and_si128(_mm_xor_si128(x, y), _mm_xor_si128(x, r))); \
+    __m128i clamp = _mm_xor_si128(top_bit_##W(x), MAXV)
+#define UNSIGNED_ADD(W, MAXV)                                                    \
+    __m128i mask = top_bit_##W(_mm_or_si128(_mm_and_si128(x, y),                 \
+                                            _mm_andnot_si128(r, _mm_or_si128(x, y)))); \
+    __m128i clamp = _mm_set1_epi32(-1)
+#define UNSIGNED_SUB(W, MAXV)                                                    \
+    __m128i mask = top_bit_##W(_mm_or_si128(_mm_andnot_si128(x, y),             \
+                                            _mm_and_si128(r, _mm_or_si128(_mm_xor_si128(x, _mm_set1_epi32(-1)), y)))); \
+    __m128i clamp = _mm_setzero_si128()
+
+#define SIMD_MASKED(NAME, T, OP, WRAP, OVERFLOW, W, MAXV)                        \
+    static size_t simd_##OP##_##NAME(T *out, const T *a, const T *b, size_t n,   \
+                                     int saturate, int *overflow) {              \
+        __m128i any = _mm_setzero_si128();                                       \
+        size_t i = 0;                                                            \
+        for (; i + 16 / sizeof(T) <= n; i += 16 / sizeof(T)) {                   \
+            __m128i x = _mm_loadu_si128((const __m128i *)(a + i));               \
+            __m128i y = _mm_loadu_si128((const __m128i *)(b + i));               \
+            __m128i r = WRAP(x, y);                                              \
+            OVERFLOW(W, MAXV);                                                   \
+            any = _mm_or_si128(any, mask);                                       \
+            _mm_storeu_si128((__m128i *)(out + i), saturate ? blend(mask, clamp, r) : r); \
+        }                                                                        \
+        *overflow |= _mm_movemask_epi8(any) != 0;                                \
+        return i;                                                                \
+    }
+
+SIMD_MASKED(i32, int32_t, add, _mm_add_epi32, SIGNED_ADD, 32, _mm_set1_epi32(INT32_MAX))
+SIMD_MASKED(i32, int32_t, sub, _mm_sub_epi32, SIGNED_SUB, 32, _mm_set1_epi32(INT32_MAX))
+SIMD_MASKED(u32, uint32_t, add, _mm_add_epi32, UNSIGNED_ADD, 32, 0)
+SIMD_MASKED(u32, uint32_t, sub, _mm_sub_epi32, UNSIGNED_SUB, 32, 0)
+SIMD_MASKED(i64, int64_t, add, _mm_add_epi64, SIGNED_ADD, 64, _mm_set1_epi64x(INT64_MAX))
+SIMD_MASKED(i64, int64_t, sub, _mm_sub_epi64, SIGNED_SUB, 64, _mm_set1_epi64x(INT64_MAX))
+SIMD_MASKED(u64, uint64_t, add, _mm_add_epi64, UNSIGNED_ADD, 64, 0)
+SIMD_MASKED(u64, uint64_t, sub, _mm_sub_epi64, UNSIGNED_SUB, 64, 0)
+
+// 16-bit mul: the low half is the wrapped product, and it fit exactly
+// when the high half is just the low half's sign extended (signed) or
+// zero (unsigned). r already holds the low half here.
+#define SIGNED_MUL(W, MAXV)                                                      \
+    __m128i mask = _mm_xor_si128(_mm_cmpeq_epi16(_mm_mulhi_epi16(x, y), top_bit_16(r)), \
+                                 _mm_set1_epi32(-1));                            \
+    __m128i clamp = _mm_xor_si128(top_bit_16(_mm_xor_si128(x, y)), MAXV)
+#define UNSIGNED_MUL(W, MAXV)                                                    \
+    __m128i mask = _mm_xor_si128(_mm_cmpeq_epi16(_mm_mulhi_epu16(x, y), _mm_setzero_si128()), \
+                                 _mm_set1_epi32(-1));                            \
+    __m128i clamp = _mm_set1_epi32(-1)
+
+SIMD_MASKED(i16, int16_t, mul, _mm_mullo_epi16, SIGNED_MUL, 16, _mm_set1_epi16(INT16_MAX))
+SIMD_MASKED(u16, uint16_t, mul, _mm_mullo_epi16, UNSIGNED_MUL, 16, 0)
+
+#else
+
+#define simd_add_i8 NO_SIMD
+#define simd_sub_i8 NO_SIMD
+#define simd_add_u8 NO_SIMD
+#define simd_sub_u8 NO_SIMD
+#define simd_add_i16 NO_SIMD
+#define simd_sub_i16 NO_SIMD
+#define simd_add_u16 NO_SIMD
+#define simd_sub_u16 NO_SIMD
+#define simd_add_i32 NO_SIMD
+#define simd_sub_i32 NO_SIMD
+#define simd_add_u32 NO_SIMD
+#define simd_sub_u32 NO_SIMD
+#define simd_add_i64 NO_SIMD
+#define simd_sub_i64 NO_SIMD
+#define simd_add_u64 NO_SIMD
+#define simd_sub_u64 NO_SIMD
+#define simd_mul_i16 NO_SIMD
+#define simd_mul_u16 NO_SIMD
+
+#endif /* __SSE2__ */
+
+// --- Public array functions ---
+
+// SIMD handles what it can, the scalar loop the rest. Overflow is
+// accumulated with |=, never branched on.
+#define ARRAY_OP(T, NAME, OP, SIMD)                                              \
+    static int array_##OP##_##NAME(T *out, const T *a, const T *b, size_t n,     \
+                                   int saturate) {                               \
+        int overflow = 0;                                                        \
+        size_t i = SIMD(out, a, b, n, saturate, &overflow);                      \
+        for (; i < n; i++) {                                                     \
+            T r;                                                                 \
+            overflow |= __builtin_##OP##_overflow(a[i], b[i], &r);               \
+            out[i] = saturate ? sat_##OP##_##NAME(a[i], b[i]) : r;               \
+        }                                                                        \
+        return !overflow;                                                        \
+    }                                                                            \
+    int sat_##OP##_##NAME##_array(T *out, const T *a, const T *b, size_t n) {    \
+        return array_##OP##_##NAME(out, a, b, n, 1);                             \
+    }                                                                            \
+    int checked_##OP##_##NAME##_array(T *out, const T *a, const T *b, size_t n) { \
+        return array_##OP##_##NAME(out, a, b, n, 0);                             \
+    }
+
+ARRAY_OP(int8_t, i8, add, simd_add_i8)
+ARRAY_OP(int8_t, i8, sub, simd_sub_i8)
+ARRAY_OP(int8_t, i8, mul, NO_SIMD)
+ARRAY_OP(int16_t, i16, add, simd_add_i16)
+ARRAY_OP(int16_t, i16, sub, simd_sub_i16)
+ARRAY_OP(int16_t, i16, mul, simd_mul_i16)
+ARRAY_OP(int32_t, i32, add, simd_add_i32)
+ARRAY_OP(int32_t, i32, sub, simd_sub_i32)
+ARRAY_OP(int32_t, i32, mul, NO_SIMD)
+ARRAY_OP(int64_t, i64, add, simd_add_i64)
+ARRAY_OP(int64_t, i64, sub, simd_sub_i64)
+ARRAY_OP(int64_t, i64, mul, NO_SIMD)
+ARRAY_OP(uint8_t, u8, add, simd_add_u8)
+ARRAY_OP(uint8_t, u8, sub, simd_sub_u8)
+ARRAY_OP(uint8_t, u8, mul, NO_SIMD)
+ARRAY_OP(uint16_t, u16, add, simd_add_u16)
+ARRAY_OP(uint16_t, u16, sub, simd_sub_u16)
+ARRAY_OP(uint16_t, u16, mul, simd_mul_u16)
+ARRAY_OP(uint32_t, u32, add, simd_add_u32)
+ARRAY_OP(uint32_t, u32, sub, simd_sub_u32)
+ARRAY_OP(uint32_t, u32, mul, NO_SIMD)
+ARRAY_OP(uint64_t, u64, add, simd_add_u64)
+ARRAY_OP(uint64_t, u64, sub, simd_sub_u64)
+ARRAY_OP(uint64_t, u64, mul, NO_SIMD)
@@ -0,0 +1,119 @@
+/*
+ * safeint.h - Checked and saturating integer arithmetic
+ *
+ * C integers wrap around silently (unsigned) or invoke undefined
+ * behaviour (signed) when a result does not fit. Python never has this
+ * problem; in C you choose what should happen instead:
+ *
+ *   checked:     report the overflow and let the caller decide
+ *                    if (!checked_add_i32(a, b, &sum)) { ... too big ... }
+ *   saturating:  clamp to the type's range, like audio or pixel math
+ *                    sat_add_u8(250, 10) == 255
+ *
+ * Every operation exists for i8, i16, i32, i64, u8, u16, u32 and u64:
+ *
+ *   int checked_add_i32(int32_t a, int32_t b, int32_t *out);  // 1 if exact
+ *   int32_t sat_add_i32(int32_t a, int32_t b);
+ *   (and _sub_, _mul_ for every type)
+ *
+ * The scalar versions use the compiler's __builtin_*_overflow, which
+ * compiles to the add/sub/mul plus a test of the CPU's overflow flag.
+ *
+ * Array versions work element by element on whole arrays and report one
+ * flag for the batch instead of branching on every element:
+ *
+ *   int sat_add_i16_array(int16_t *out, const int16_t *a,
+ *                         const int16_t *b, size_t n);
+ *       // out[i] = sat_add_i16(a[i], b[i]); returns 1 if nothing clamped
+ *   int checked_add_i16_array(...same...);
+ *       // out[i] = a[i] + b[i] wrapped; returns 1 if nothing overflowed
+ *
+ * out may be the same array as a or b.
+ *
+ * Build: add ../common/safeint.c to the cc command line (only needed for
+ * the array versions).
+ */
+
+#ifndef SAFEINT_H
+#define SAFEINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Scalar operations for a signed type. On overflow, the true result's
+// sign says which end to clamp to.
+#define SAFEINT_SIGNED(T, NAME, MIN, MAX)                                        \
+    static inline int checked_add_##NAME(T a, T b, T *out) {                     \
+        return !__builtin_add_overflow(a, b, out);                               \
+    }                                                                            \
+    static inline int checked_sub_##NAME(T a, T b, T *out) {                     \
+        return !__builtin_sub_overflow(a, b, out);                               \
+    }                                                                            \
+    static inline int checked_mul_##NAME(T a, T b, T *out) {                     \
+        return !__builtin_mul_overflow(a, b, out);                               \
+    }                                                                            \
+    static inline T sat_add_##NAME(T a, T b) {                                   \
+        T r;                                                                     \
+        return __builtin_add_overflow(a, b, &r) ? (a < 0 ? MIN : MAX) : r;       \
+    }                                                                            \
+    static inline T sat_sub_##NAME(T a, T b) {                                   \
+        T r;                                                                     \
+        return __builtin_sub_overflow(a, b, &r) ? (a < 0 ? MIN : MAX) : r;       \
+    }                                                                            \
+    static inline T sat_mul_##NAME(T a, T b) {                                   \
+        T r;                                                                     \
+        return __builtin_mul_overflow(a, b, &r) ? ((a < 0) != (b < 0) ? MIN : MAX) : r; \
+    }
+
+// Unsigned types can only overflow past the top, or below 0 for sub
+#define SAFEINT_UNSIGNED(T, NAME, MAX)                                           \
+    static inline int checked_add_##NAME(T a, T b, T *out) {                     \
+        return !__builtin_add_overflow(a, b, out);                               \
+    }                                                                            \
+    static inline int checked_sub_##NAME(T a, T b, T *out) {                     \
+        return !__builtin_sub_overflow(a, b, out);                               \
+    }                                                                            \
+    static inline int checked_mul_##NAME(T a, T b, T *out) {                     \
+        return !__builtin_mul_overflow(a, b, out);                               \
+    }                                                                            \
+    static inline T sat_add_##NAME(T a, T b) {                                   \
+        T r;                                                                     \
+        return __builtin_add_overflow(a, b, &r) ? MAX : r;                       \
+    }                                                                            \
+    static inline T sat_sub_##NAME(T a, T b) {                                   \
+        T r;                                                                     \
+        return __builtin_sub_overflow(a, b, &r) ? 0 : r;                         \
+    }                                                                            \
+    static inline T sat_mul_##NAME(T a, T b) {                                   \
+        T r;                                                                     \
+        return __builtin_mul_overflow(a, b, &r) ? MAX : r;                       \
+    }
+
+SAFEINT_SIGNED(int8_t, i8, INT8_MIN, INT8_MAX)
+SAFEINT_SIGNED(int16_t, i16, INT16_MIN, INT16_MAX)
+SAFEINT_SIGNED(int32_t, i32, INT32_MIN, INT32_MAX)
+SAFEINT_SIGNED(int64_t, i64, INT64_MIN, INT64_MAX)
+SAFEINT_UNSIGNED(uint8_t, u8, UINT8_MAX)
+SAFEINT_UNSIGNED(uint16_t, u16, UINT16_MAX)
+SAFEINT_UNSIGNED(uint32_t, u32, UINT32_MAX)
+SAFEINT_UNSIGNED(uint64_t, u64, UINT64_MAX)
+
+// Array versions, defined in safeint.c
+#define SAFEINT_ARRAY_OPS(T, NAME)                                                      \
+    int sat_add_##NAME##_array(T *out, const T *a, const T *b, size_t n);               \
+    int sat_sub_##NAME##_array(T *out, const T *a, const T *b, size_t n);               \
+    int sat_mul_##NAME##_array(T *out, const T *a, const T *b, size_t n);               \
+    int checked_add_##NAME##_array(T *out, const T *a, const T *b, size_t n);           \
+    int checked_sub_##NAME##_array(T *out, const T *a, const T *b, size_t n);           \
+    int checked_mul_##NAME##_array(T *out, const T *a, const T *b, size_t n);
+
+SAFEINT_ARRAY_OPS(int8_t, i8)
+SAFEINT_ARRAY_OPS(int16_t, i16)
+SAFEINT_ARRAY_OPS(int32_t, i32)
+SAFEINT_ARRAY_OPS(int64_t, i64)
+SAFEINT_ARRAY_OPS(uint8_t, u8)
+SAFEINT_ARRAY_OPS(uint16_t, u16)
+SAFEINT_ARRAY_OPS(uint32_t, u32)
+SAFEINT_ARRAY_OPS(uint64_t, u64)
+
+#endif /* SAFEINT_H */
@@ -0,0 +1,134 @@
+/*
+ * wordsplit.c - Shared word-splitting helpers
+ *
+ * The bulk paths look at 64 bytes at a time. Each byte becomes one bit
+ * of a "is whitespace" mask, and a word starts wherever a non-space bit
+ * follows a space bit:
+ *
+ *   text:    "  hi there"
+ *   space:    1100100000   (bit per byte)
+ *   starts:   0010010000   = ~space & (space shifted by one)
+ *
+ * so counting words is a popcount instead of a branch per byte. On x86
+ * the mask comes from SSE2 compares; elsewhere the table loop runs.
+ */
+
+#include "wordsplit.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+const unsigned char ws_space_table[256] = {
+    ['\t'] = 1, ['\n'] = 1, ['\v'] = 1, ['\f'] = 1, ['\r'] = 1, [' '] = 1
+};
+
+#ifdef __SSE2__
+// Bit i set if p[i] is whitespace. Must agree with ws_space_table:
+// ' ' or a byte in '\t'..'\r' (9..13).
+static inline unsigned int space_mask16(const char *p) {
+    __m128i v = _mm_loadu_si128((const __m128i *)p);
+    __m128i is_blank = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+    __m128i off = _mm_sub_epi8(v, _mm_set1_epi8('\t'));
+    __m128i is_ctrl = _mm_cmpeq_epi8(_mm_min_epu8(off, _mm_set1_epi8(4)), off);
+    return (unsigned int)_mm_movemask_epi8(_mm_or_si128(is_blank, is_ctrl));
+}
+
+static inline unsigned long long space_mask64(const char *p) {
+    return (unsigned long long)space_mask16(p)
+         | (unsigned long long)space_mask16(p + 16) << 16
+         | (unsigned long long)space_mask16(p + 32) << 32
+         | (unsigned long long)space_mask16(p + 48) << 48;
+}
+
+static inline unsigned int newline_mask16(const char *p) {
+    __m128i v = _mm_loadu_si128((const __m128i *)p);
+    return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+}
+#endif
+
+size_t ws_count_words(const char *buf, size_t len, int *in_word) {
+    size_t words = 0;
+    size_t i = 0;
+    int inside = *in_word;
+
+#ifdef __SSE2__
+    // Bit 0 of "prev" says whether the byte before this block was a space
+    unsigned long long prev = inside ? 0 : 1;
+    for (; i + 64 <= len; i += 64) {
+        unsigned long long space = space_mask64(buf + i);
+        unsigned long long starts = ~space & ((space << 1) | prev);
+        words += (size_t)__builtin_popcountll(starts);
+        prev = space >> 63;
+    }
+    inside = !prev;
+#endif
+
+    for (; i < len; i++) {
+        if (ws_is_space((unsigned char)buf[i])) {
+            inside = 0;
+        } else if (!inside) {
+            inside = 1;
+            words++;
+        }
+    }
+
+    *in_word = inside;
+    return words;
+}
+
+size_t ws_count_lines(const char *buf, size_t len) {
+    size_t lines = 0;
+    size_t i = 0;
+
+#ifdef __SSE2__
+    for (; i + 16 <= len; i += 16) {
+        lines += (size_t)__builtin_popcount(newline_mask16(buf + i));
+    }
+#endif
+
+    for (; i < len; i++) {
+        lines += (buf[i] == '\n');
+    }
+    return lines;
+}
+
+// Index of the first byte at or after pos whose "is space" equals want,
+// or len if there is none.
+static size_t scan_until(const char *buf, size_t len, size_t pos, int want) {
+#ifdef __SSE2__
+    while (pos + 16 <= len) {
+        unsigned int mask = space_mask16(buf + pos);
+        if (!want) {
+            mask = ~mask & 0xFFFF;
+        }
+        if (mask != 0) {
+            return pos + (size_t)__builtin_ctz(mask);
+        }
+        pos += 16;
+    }
+#endif
+    while (pos < len && ws_is_space((unsigned char)buf[pos]) != want) {
+        pos++;
+    }
+    return pos;
+}
+
+void ws_tokenizer_init(WordTokenizer *t, const char *buf, size_t len) {
+    t->buf = buf;
+    t->len = len;
+    t->pos = 0;
+}
+
+int ws_next_word(WordTokenizer *t, WordSpan *span) {
+    size_t start = scan_until(t->buf, t->len, t->pos, 0);
+    if (start == t->len) {
+        t->pos = start;
+        return 0;
+    }
+    size_t end = scan_until(t->buf, t->len, start, 1);
+    span->offset = start;
+    span->length = end - start;
+    t->pos = end;
+    return 1;
+}